@@ -0,0 +1,32 @@
+#version 330 core
+layout (location = 0) in vec4 vertex;
+layout (location = 1) in uvec2 cell;
+layout (location = 2) in uint style;
+layout (location = 3) in float alive;
+
+layout (std140) uniform Frame
+{
+	mat4 proj_mat;
+	vec2 screen_size;
+	float time;
+};
+uniform vec2 cell_size;
+uniform vec3 style_colors[8];
+uniform vec4 style_tex_rects[8];
+
+out vec2 tex_coords;
+out vec3 sprite_color;
+
+void main()
+{
+	tex_coords = mix(style_tex_rects[style].xy, style_tex_rects[style].zw, vertex.zw);
+	sprite_color = style_colors[style];
+
+	if (alive < 0.5) {
+		// destroyed, move the quad out of the clip volume
+		gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+		return;
+	}
+
+	gl_Position = proj_mat * vec4((vec2(cell) + vertex.xy) * cell_size, 0.0, 1.0);
+}
\ No newline at end of file
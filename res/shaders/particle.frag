@@ -2,12 +2,12 @@
 
 out vec4 frag_color;
 in vec2 tex_coords;
+in vec4 particle_color;
 
 uniform sampler2D image;
-uniform vec4 color;
 
 void main() 
 {
 	vec4 tex_color = texture(image, tex_coords);
-	frag_color = tex_color * color;
+	frag_color = tex_color * particle_color;
 }
\ No newline at end of file
@@ -1,15 +1,25 @@
 #version 330 core
 layout (location = 0) in vec4 vertex;
+layout (location = 1) in vec2 pos;
+layout (location = 2) in vec4 color;
 
-uniform mat4 proj_mat;
-uniform vec2 pos;
+layout (std140) uniform Frame
+{
+	mat4 proj_mat;
+	vec2 screen_size;
+	float time;
+};
+uniform vec4 tex_rect; // u0, v0, u1, v1
 
 out vec2 tex_coords;
+out vec4 particle_color;
 
 void main()
 {
 	float scale = 10.0f;
 
 	gl_Position =  proj_mat * vec4(vertex.xy * scale + pos, 0.0f, 1.0f);
-	tex_coords = vec2(vertex.z, vertex.w);
+	tex_coords = mix(tex_rect.xy, tex_rect.zw, vertex.zw);
+	// the sprite is premultiplied, so is the fading color
+	particle_color = vec4(color.rgb * color.a, color.a);
 }
\ No newline at end of file
@@ -0,0 +1,52 @@
+#version 330 core
+layout (location = 0) in vec2 pos;
+layout (location = 1) in vec2 velocity;
+layout (location = 2) in vec4 color;
+layout (location = 3) in float life;
+
+uniform float dt;
+uniform int particle_count;
+uniform int spawn_begin; // first slot of the ring window respawned this step
+uniform int spawn_count;
+uniform vec2 emitter_pos;
+uniform vec2 emitter_velocity;
+uniform uint seed;
+
+// captured by transform feedback, same layout as the input
+out vec2 out_pos;
+out vec2 out_velocity;
+out vec4 out_color;
+out float out_life;
+
+float Random(uint n)
+{
+	n = (n << 13u) ^ n;
+	n = n * (n * n * 15731u + 789221u) + 1376312589u;
+	return float(n & 0x7fffffffu) / float(0x7fffffff);
+}
+
+void main()
+{
+	out_pos = pos;
+	out_velocity = velocity;
+	out_color = color;
+	out_life = life;
+
+	int slot = (gl_VertexID - spawn_begin + particle_count) % particle_count;
+	if (slot < spawn_count) {
+		uint id = uint(gl_VertexID) * 2u + seed;
+		float color_value = Random(id) * 0.5f + 0.5f;
+		float rand_value = Random(id + 1u) * 10.0f - 5.0f;
+
+		out_pos = emitter_pos + vec2(rand_value, rand_value);
+		out_velocity = emitter_velocity;
+		out_color = vec4(color_value, color_value, color_value, 1.0f);
+		out_life = 1.0f;
+	}
+
+	out_life -= dt;
+	if (out_life >= 0.0f) {
+		out_pos -= dt * out_velocity;
+		out_color.a = max(0.0f, out_color.a - dt * 2.5f);
+	}
+}
\ No newline at end of file
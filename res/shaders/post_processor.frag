@@ -5,9 +5,7 @@ in vec2 tex_coords;
 
 uniform sampler2D scene;
 
-uniform bool is_shake;
-uniform bool is_confuse;
-uniform bool is_chaos;
+// variants are selected with SHAKE, CONFUSE and CHAOS defines
 
 uniform vec2[9] offsets;
 uniform float[9] blur_kernels;
@@ -27,18 +25,19 @@ vec4 CalcKernelColor(float kernels[9])
 
 void main() 
 {
+#if defined(CHAOS)
+	// the edge kernel replaces the color, a shake blur would be discarded
+	vec4 color = CalcKernelColor(edge_kernels);
+#else
+#ifdef SHAKE
+	vec4 color = CalcKernelColor(blur_kernels);
+#else
 	vec4 color = texture(scene, tex_coords);
-
-	if(is_shake) {
-		color = CalcKernelColor(blur_kernels);
-	}
-
-	if(is_chaos) {
-		color = CalcKernelColor(edge_kernels);
-	}
-	else if(is_confuse) {
-		color = vec4(1.0 - color.rgb, 1.0);
-	}
+#endif
+#ifdef CONFUSE
+	color = vec4(1.0 - color.rgb, 1.0);
+#endif
+#endif
 
 	frag_color = color;
 }
\ No newline at end of file
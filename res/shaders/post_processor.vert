@@ -1,35 +1,34 @@
 #version 330 core
 layout (location = 0) in vec4 vertex;
 
-uniform mat4 model_mat;
-uniform mat4 proj_mat;
-
-uniform bool is_shake;
-uniform bool is_confuse;
-uniform bool is_chaos;
+layout (std140) uniform Frame
+{
+	mat4 proj_mat;
+	vec2 screen_size;
+	float time;
+};
 
-uniform float time;
+// variants are selected with SHAKE, CONFUSE and CHAOS defines
 
 out vec2 tex_coords;
 
 void main()
 {
-	gl_Position =  proj_mat * model_mat * vec4(vertex.xy, 0.0, 1.0);
+	gl_Position =  proj_mat * vec4(vertex.xy * screen_size, 0.0, 1.0);
 	vec2 vertex_tex_coords = vertex.zw;
 
-	if(is_chaos) {
-		float strength = 0.3;
-		vertex_tex_coords = vec2(vertex_tex_coords.s + sin(time) * strength, vertex_tex_coords.t + cos(time) * strength);
-	}
-	else if(is_confuse) {
-		vertex_tex_coords = vec2(1.0 - vertex_tex_coords.s, 1.0 - vertex_tex_coords.t);
-	}
-
-	if(is_shake) {
-		float strength = 0.01;
-		gl_Position.x += cos(time * 10) * strength;
-		gl_Position.y += cos(time * 15) * strength;
-	}
+#if defined(CHAOS)
+	float strength = 0.3;
+	vertex_tex_coords = vec2(vertex_tex_coords.s + sin(time) * strength, vertex_tex_coords.t + cos(time) * strength);
+#elif defined(CONFUSE)
+	vertex_tex_coords = vec2(1.0 - vertex_tex_coords.s, 1.0 - vertex_tex_coords.t);
+#endif
+
+#ifdef SHAKE
+	float shake_strength = 0.01;
+	gl_Position.x += cos(time * 10) * shake_strength;
+	gl_Position.y += cos(time * 15) * shake_strength;
+#endif
 
 	tex_coords = vec2(vertex_tex_coords.s, 1 - vertex_tex_coords.t);
 }
\ No newline at end of file
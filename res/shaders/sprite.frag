@@ -2,12 +2,13 @@
 
 out vec4 frag_color;
 in vec2 tex_coords;
+in vec3 sprite_color;
 
 uniform sampler2D image;
-uniform vec3 sprite_color;
 
 void main() 
 {
+	// premultiplied, tinting the color keeps it premultiplied
 	vec4 color = texture(image, tex_coords);
 	frag_color = vec4(sprite_color, 1.0) * color;
 }
\ No newline at end of file
@@ -1,13 +1,29 @@
 #version 330 core
 layout (location = 0) in vec4 vertex;
+layout (location = 1) in vec4 instance_rect;     // pos.xy, size.xy
+layout (location = 2) in vec4 instance_color;    // rgb, rotate
+layout (location = 3) in vec4 instance_tex_rect; // u0, v0, u1, v1
 
-uniform mat4 model_mat;
-uniform mat4 proj_mat;
+layout (std140) uniform Frame
+{
+	mat4 proj_mat;
+	vec2 screen_size;
+	float time;
+};
 
 out vec2 tex_coords;
+out vec3 sprite_color;
 
 void main()
 {
-	gl_Position = proj_mat * model_mat * vec4(vertex.x, vertex.y, 0.0, 1.0);
-	tex_coords = vec2(vertex.z, vertex.w);
+	vec2 size = instance_rect.zw;
+
+	// rotate around the sprite center
+	float angle = radians(instance_color.w);
+	vec2 local = vertex.xy * size - 0.5 * size;
+	local = vec2(cos(angle) * local.x - sin(angle) * local.y, sin(angle) * local.x + cos(angle) * local.y);
+
+	gl_Position = proj_mat * vec4(instance_rect.xy + local + 0.5 * size, 0.0, 1.0);
+	tex_coords = mix(instance_tex_rect.xy, instance_tex_rect.zw, vertex.zw);
+	sprite_color = instance_color.rgb;
 }
\ No newline at end of file
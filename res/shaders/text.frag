@@ -1,9 +1,9 @@
 #version 330 core
 in vec2 texCoords;
+in vec3 textColor;
 out vec4 color;
 
 uniform sampler2D text;
-uniform vec3 textColor;
 
 void main()
 {    
@@ -1,11 +1,20 @@
 #version 330 core
 layout (location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
+layout (location = 1) in vec3 color;
 out vec2 texCoords;
+out vec3 textColor;
 
-uniform mat4 projectionMat;
+layout (std140) uniform Frame
+{
+    mat4 proj_mat;
+    vec2 screen_size;
+    float time;
+};
 
 void main()
 {
-    gl_Position = projectionMat * vec4(vertex.xy, 0.0, 1.0);
+    // text is laid out with the origin at the bottom
+    gl_Position = proj_mat * vec4(vertex.x, screen_size.y - vertex.y, 0.0, 1.0);
     texCoords = vertex.zw;
+    textColor = color;
 }
\ No newline at end of file
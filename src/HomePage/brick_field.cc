@@ -0,0 +1,182 @@
+#include "brick_field.h"
+
+#include <algorithm>
+
+// clang-format off
+static float brick_vertices[] = {
+	// vertext   // texture pos
+	0.0f, 1.0f, 0.0f, 1.0f,
+	1.0f, 1.0f, 1.0f, 1.0f,
+	0.0f, 0.0f, 0.0f, 0.0f,
+
+	1.0f, 0.0f, 1.0f, 0.0f,
+	0.0f, 0.0f, 0.0f, 0.0f,
+	1.0f, 1.0f, 1.0f, 1.0f,
+};
+// clang-format on
+
+BrickField::BrickField(std::shared_ptr<QOpenGLShaderProgram> shader)
+    : is_uniform_dirty_(true)
+    , is_layout_dirty_(false)
+    , dirty_begin_(0)
+    , dirty_end_(0)
+    , vao_(0)
+    , quad_vbo_(0)
+    , instance_vbo_(0)
+    , alive_vbo_(0)
+    , shader_(shader)
+    , gl_state_(Singleton<GlStateCache>::Instance())
+{
+    for (int i = 0; i < kMaxStyles; ++i) {
+        style_colors_[i] = QVector3D(1.0f, 1.0f, 1.0f);
+        style_tex_rects_[i] = QVector4D(0.0f, 0.0f, 1.0f, 1.0f);
+    }
+
+    InitRenderData();
+}
+
+BrickField::~BrickField()
+{
+    glDeleteVertexArrays(1, &vao_);
+    glDeleteBuffers(1, &quad_vbo_);
+    glDeleteBuffers(1, &instance_vbo_);
+    glDeleteBuffers(1, &alive_vbo_);
+}
+
+void BrickField::SetCellSize(const QVector2D& cell_size)
+{
+    cell_size_ = cell_size;
+    is_uniform_dirty_ = true;
+}
+
+void BrickField::SetStyle(int style, const QVector3D& color, const TextureRegion& sprite)
+{
+    if (style < 0 || style >= kMaxStyles)
+        return;
+
+    style_colors_[style] = color;
+    style_tex_rects_[style] = sprite.tex_rect;
+    if (sprite.texture) {
+        texture_ = sprite.texture;
+    }
+    is_uniform_dirty_ = true;
+}
+
+void BrickField::Clear()
+{
+    instances_.clear();
+    alive_.clear();
+    is_layout_dirty_ = true;
+}
+
+int BrickField::AddBrick(int col, int row, int style)
+{
+    BrickInstance instance = {(quint16)col, (quint16)row, (quint8)style, {0, 0, 0}};
+    instances_.emplace_back(instance);
+    alive_.emplace_back(1);
+    is_layout_dirty_ = true;
+
+    return (int)instances_.size() - 1;
+}
+
+void BrickField::Destroy(int index)
+{
+    if (index < 0 || index >= (int)alive_.size() || alive_[index] == 0)
+        return;
+
+    alive_[index] = 0;
+
+    if (dirty_begin_ == dirty_end_) {
+        dirty_begin_ = index;
+        dirty_end_ = index + 1;
+    } else {
+        dirty_begin_ = std::min(dirty_begin_, index);
+        dirty_end_ = std::max(dirty_end_, index + 1);
+    }
+}
+
+void BrickField::Draw()
+{
+    if (instances_.empty())
+        return;
+
+    Upload();
+
+    gl_state_->UseProgram(shader_->programId());
+    if (is_uniform_dirty_) {
+        shader_->setUniformValue("image", 0);
+        shader_->setUniformValue("cell_size", cell_size_);
+        shader_->setUniformValueArray("style_colors", style_colors_, kMaxStyles);
+        shader_->setUniformValueArray("style_tex_rects", style_tex_rects_, kMaxStyles);
+        is_uniform_dirty_ = false;
+    }
+
+    gl_state_->SetBlend(true);
+    gl_state_->BlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); // premultiplied textures
+    gl_state_->BindTexture(texture_ ? texture_->textureId() : 0);
+
+    gl_state_->BindVertexArray(vao_);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, (GLsizei)instances_.size());
+}
+
+void BrickField::InitRenderData()
+{
+    initializeOpenGLFunctions();
+
+    glGenVertexArrays(1, &vao_);
+    gl_state_->BindVertexArray(vao_);
+
+    glGenBuffers(1, &quad_vbo_);
+    glBindBuffer(GL_ARRAY_BUFFER, quad_vbo_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(brick_vertices), brick_vertices, GL_STATIC_DRAW);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(float) * 4, nullptr);
+
+    // static per-brick layout
+    glGenBuffers(1, &instance_vbo_);
+    glBindBuffer(GL_ARRAY_BUFFER, instance_vbo_);
+
+    glEnableVertexAttribArray(1);
+    glVertexAttribIPointer(1, 2, GL_UNSIGNED_SHORT, sizeof(BrickInstance), nullptr);
+    glVertexAttribDivisor(1, 1);
+
+    glEnableVertexAttribArray(2);
+    glVertexAttribIPointer(2, 1, GL_UNSIGNED_BYTE, sizeof(BrickInstance),
+                           (void*)(sizeof(quint16) * 2));
+    glVertexAttribDivisor(2, 1);
+
+    // one byte per brick, rewritten when a brick is destroyed
+    glGenBuffers(1, &alive_vbo_);
+    glBindBuffer(GL_ARRAY_BUFFER, alive_vbo_);
+
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 1, GL_UNSIGNED_BYTE, GL_FALSE, sizeof(quint8), nullptr);
+    glVertexAttribDivisor(3, 1);
+
+    gl_state_->BindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void BrickField::Upload()
+{
+    if (is_layout_dirty_) {
+        glBindBuffer(GL_ARRAY_BUFFER, instance_vbo_);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(BrickInstance) * instances_.size(), instances_.data(),
+                     GL_STATIC_DRAW);
+
+        glBindBuffer(GL_ARRAY_BUFFER, alive_vbo_);
+        glBufferData(GL_ARRAY_BUFFER, alive_.size(), alive_.data(), GL_DYNAMIC_DRAW);
+
+        is_layout_dirty_ = false;
+    } else if (dirty_begin_ != dirty_end_) {
+        glBindBuffer(GL_ARRAY_BUFFER, alive_vbo_);
+        glBufferSubData(GL_ARRAY_BUFFER, dirty_begin_, dirty_end_ - dirty_begin_,
+                        alive_.data() + dirty_begin_);
+    } else {
+        return;
+    }
+
+    dirty_begin_ = dirty_end_ = 0;
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,80 @@
+#ifndef BRICK_FIELD_H_
+#define BRICK_FIELD_H_
+
+#include <QOpenGLFunctions_3_3_Core>
+#include <QOpenGLShaderProgram>
+#include <QVector2D>
+#include <QVector3D>
+#include <memory>
+#include <vector>
+
+#include "gl_state_cache.h"
+#include "texture_atlas.h"
+
+/**
+ * @brief GPU-resident brick field. The grid layout is uploaded once as a static instance buffer,
+ * destroyed bricks only update their byte in the alive buffer, and the field draws in one call.
+ */
+class BrickField : protected QOpenGLFunctions_3_3_Core
+{
+public:
+    static constexpr int kMaxStyles = 8;
+
+    BrickField(std::shared_ptr<QOpenGLShaderProgram> shader);
+    ~BrickField();
+
+    void SetCellSize(const QVector2D& cell_size);
+
+    /**
+     * @brief All styles are expected to live on the same atlas page.
+     */
+    void SetStyle(int style, const QVector3D& color, const TextureRegion& sprite);
+
+    void Clear();
+    int AddBrick(int col, int row, int style);
+    void Destroy(int index);
+
+    void Draw();
+
+    inline int Count();
+
+private:
+    struct BrickInstance
+    {
+        quint16 col;
+        quint16 row;
+        quint8 style;
+        quint8 padding[3];
+    };
+
+    void InitRenderData();
+    void Upload();
+
+private:
+    QVector2D cell_size_;
+    bool is_uniform_dirty_;
+
+    QVector3D style_colors_[kMaxStyles];
+    QVector4D style_tex_rects_[kMaxStyles];
+    std::shared_ptr<QOpenGLTexture> texture_;
+
+    std::vector<BrickInstance> instances_;
+    std::vector<quint8> alive_;
+    bool is_layout_dirty_;
+    int dirty_begin_;
+    int dirty_end_;
+
+    quint32 vao_;
+    quint32 quad_vbo_;
+    quint32 instance_vbo_;
+    quint32 alive_vbo_;
+    std::shared_ptr<QOpenGLShaderProgram> shader_;
+    std::shared_ptr<GlStateCache> gl_state_;
+};
+
+inline int BrickField::Count()
+{
+    return (int)instances_.size();
+}
+
+#endif
@@ -0,0 +1,99 @@
+#include "frame_pacer.h"
+
+#include <algorithm>
+#include <cmath>
+
+FramePacer::FramePacer(int window)
+    : last_swap_ns_(0)
+    , intervals_(std::max(window, 1), 0.0f)
+    , next_(0)
+    , count_(0)
+    , frame_cap_(0)
+    , refresh_rate_(60.0f)
+{
+    clock_.start();
+}
+
+void FramePacer::SetFrameCap(int fps)
+{
+    frame_cap_ = std::max(fps, 0);
+}
+
+void FramePacer::SetRefreshRate(float hz)
+{
+    if (hz > 0.0f) {
+        refresh_rate_ = hz;
+    }
+}
+
+void FramePacer::FrameSwapped()
+{
+    qint64 now_ns = clock_.nsecsElapsed();
+    if (last_swap_ns_ > 0) {
+        intervals_[next_] = (now_ns - last_swap_ns_) / 1e6f;
+        next_ = (next_ + 1) % (int)intervals_.size();
+        count_ = std::min(count_ + 1, (int)intervals_.size());
+    }
+    last_swap_ns_ = now_ns;
+}
+
+void FramePacer::Pause()
+{
+    last_swap_ns_ = 0;
+}
+
+int FramePacer::DelayToNextFrameMs(int max_fps)
+{
+    int cap = frame_cap_;
+    if (max_fps > 0 && (cap <= 0 || max_fps < cap)) {
+        cap = max_fps;
+    }
+
+    if (cap <= 0)
+        return 0;
+
+    // The swap blocks until the next refresh, so aim half a refresh early.
+    float elapsed_ms = (clock_.nsecsElapsed() - last_swap_ns_) / 1e6f;
+    float delay_ms = TargetIntervalMs(cap) - elapsed_ms - 500.0f / refresh_rate_;
+
+    return std::max(0, (int)delay_ms);
+}
+
+FramePacer::Stats FramePacer::CalcStats()
+{
+    Stats stats;
+    if (count_ == 0)
+        return stats;
+
+    float sum = 0.0f;
+    stats.min_ms = intervals_[0];
+    stats.max_ms = intervals_[0];
+    for (int i = 0; i < count_; ++i) {
+        sum += intervals_[i];
+        stats.min_ms = std::min(stats.min_ms, intervals_[i]);
+        stats.max_ms = std::max(stats.max_ms, intervals_[i]);
+    }
+    stats.avg_ms = sum / count_;
+    stats.fps = stats.avg_ms > 0.0f ? 1000.0f / stats.avg_ms : 0.0f;
+
+    float missed_ms = TargetIntervalMs(frame_cap_) * 1.5f;
+    float variance = 0.0f;
+    for (int i = 0; i < count_; ++i) {
+        variance += (intervals_[i] - stats.avg_ms) * (intervals_[i] - stats.avg_ms);
+        if (intervals_[i] > missed_ms) {
+            ++stats.missed;
+        }
+    }
+    stats.jitter_ms = std::sqrt(variance / count_);
+
+    return stats;
+}
+
+float FramePacer::TargetIntervalMs(int cap)
+{
+    float refresh_ms = 1000.0f / refresh_rate_;
+    if (cap <= 0)
+        return refresh_ms;
+
+    return std::max(1000.0f / cap, refresh_ms);
+}
@@ -0,0 +1,70 @@
+#ifndef FRAME_PACER_H_
+#define FRAME_PACER_H_
+
+#include <QElapsedTimer>
+#include <vector>
+
+/**
+ * @brief Presentation timing. FrameSwapped() is called once per presented frame, the intervals
+ * are kept over a rolling window, and DelayToNextFrameMs() tells how long to hold the next
+ * frame back to honour the frame cap. Without a cap the swap itself paces the loop (vsync).
+ */
+class FramePacer
+{
+public:
+    struct Stats
+    {
+        float fps = 0.0f;
+        float avg_ms = 0.0f;
+        float min_ms = 0.0f;
+        float max_ms = 0.0f;
+        float jitter_ms = 0.0f; // standard deviation of the intervals
+        int missed = 0;         // intervals longer than 1.5 target intervals
+    };
+
+    FramePacer(int window = 120);
+    ~FramePacer() = default;
+
+    /**
+     * @param fps Frames per second, 0 renders once per display refresh.
+     */
+    void SetFrameCap(int fps);
+    inline int FrameCap();
+
+    void SetRefreshRate(float hz);
+
+    void FrameSwapped();
+
+    /**
+     * @brief Call when the loop stops on purpose, the gap to the next swap is not recorded.
+     */
+    void Pause();
+
+    /**
+     * @param max_fps Tighter cap for this frame only, e.g. while the scene is barely changing.
+     */
+    int DelayToNextFrameMs(int max_fps = 0);
+
+    Stats CalcStats();
+
+private:
+    float TargetIntervalMs(int cap);
+
+private:
+    QElapsedTimer clock_;
+    qint64 last_swap_ns_;
+
+    std::vector<float> intervals_;
+    int next_;
+    int count_;
+
+    int frame_cap_;
+    float refresh_rate_;
+};
+
+inline int FramePacer::FrameCap()
+{
+    return frame_cap_;
+}
+
+#endif
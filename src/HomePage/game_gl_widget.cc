@@ -1,36 +1,52 @@
 #include "game_gl_widget.h"
 
 #include <QApplication>
-#include <QDateTime>
 #include <QMediaPlayer>
-#include <QOpenGLTexture>
+#include <QScreen>
+#include <QWindow>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
 
 #include "audio_manager.h"
-#include "collision_helper.h"
-#include "particle_generator.h"
-#include "post_processor.h"
-#include "resource_manager.h"
+#include "gl_state_cache.h"
 
 constexpr float kVelocity = 35.0f;
-constexpr float kSphereRadius = 12.5f;
-constexpr QVector2D kPlayerSize(100.0f, 20.0f);
+
+// F4 cycles through these, 0 renders once per display refresh
+constexpr int kFrameCaps[] = {0, 30, 60, 120};
+constexpr int kFrameCapCount = sizeof(kFrameCaps) / sizeof(kFrameCaps[0]);
+// The win screen only has the chaos effect moving, covered windows only need a heartbeat.
+constexpr int kAmbientFps = 30;
+constexpr int kBackgroundFps = 4;
+
+// F5 writes the GPU stage timings here while the overlay is on
+constexpr const char* kGpuStatsFile = "gpu_stats.csv";
 
 GameGlWidget::GameGlWidget(QWidget* parent)
     : QOpenGLWidget(parent)
-    , game_state_(std::make_unique<GameState>())
-    , game_level_(std::make_unique<GameLevel>(width(), height()))
-    , powerup_manager_(std::make_shared<PowerUpManager>())
+    , scene_(std::make_unique<GameScene>())
 {
     setFocusPolicy(Qt::StrongFocus);
-    game_state_->SetLives(3);
-    game_level_->SetLevelNum(4);
 
     InitBgMusic();
+
+    // Presentation drives the loop: every swapped frame schedules the next one, and the
+    // simulation catches up at the start of each paint.
+    frame_timer_ = new QTimer(this);
+    frame_timer_->setTimerType(Qt::PreciseTimer);
+    frame_timer_->setSingleShot(true);
+    connect(frame_timer_, &QTimer::timeout, this, [this]() { update(); });
+    connect(this, &QOpenGLWidget::frameSwapped, this, &GameGlWidget::OnFrameSwapped);
 }
 
 GameGlWidget::~GameGlWidget()
 {
-    Singleton<ResourceManager>::ReleaseInstance();
+    // The scene owns GL objects, release them with the context current.
+    makeCurrent();
+    scene_.reset();
+    doneCurrent();
+
     Singleton<AudioManager>::Instance()->Stop();
 }
 
@@ -38,373 +54,224 @@ void GameGlWidget::initializeGL()
 {
     initializeOpenGLFunctions();
 
-    auto res_manager = Singleton<ResourceManager>::Instance();
-
-    // sprites
-    auto shader_program = std::make_shared<QOpenGLShaderProgram>();
-    shader_program->addShaderFromSourceFile(QOpenGLShader::Vertex, ":/res/shaders/sprite.vert");
-    shader_program->addShaderFromSourceFile(QOpenGLShader::Fragment, ":/res/shaders/sprite.frag");
-    shader_program->link();
-
-    sprite_renderer_ = std::make_shared<SpriteRenderer>(shader_program);
-    bg_tex_ = res_manager->Texture("background", ":/res/images/background.jpg", false);
-    paddle_tex_ = res_manager->Texture("paddle", ":/res/images/paddle.png", false);
-    sphere_tex_ = res_manager->Texture("awesomeface", ":/res/images/awesomeface.png", false);
-    sphere_tex_->setWrapMode(QOpenGLTexture::ClampToEdge);
-
-    player_ = std::make_unique<GameObject>(QVector2D(0.0f, 0.0f), kPlayerSize,
-                                           QVector3D(1.0f, 1.0f, 1.0f), paddle_tex_);
-
-    sphere_ = std::make_unique<SphereObject>(QVector2D(0.0f, 0.0f), kSphereRadius,
-                                             QVector3D(1.0f, 1.0f, 1.0f), sphere_tex_);
-
-    // particles
-    particle_shader_ = std::make_shared<QOpenGLShaderProgram>();
-    particle_shader_->addShaderFromSourceFile(QOpenGLShader::Vertex, ":/res/shaders/particle.vert");
-    particle_shader_->addShaderFromSourceFile(QOpenGLShader::Fragment,
-                                              ":/res/shaders/particle.frag");
-    particle_shader_->link();
-
-    auto particle_tex = res_manager->Texture("particle", ":/res/images/particle.png", true);
-    particle_generator_ = std::make_shared<ParticleGenerator>(particle_shader_, particle_tex);
-
-    // post-process
-    auto post_shader = std::make_shared<QOpenGLShaderProgram>();
-    post_shader->addShaderFromSourceFile(QOpenGLShader::Vertex,
-                                         ":/res/shaders/post_processor.vert");
-    post_shader->addShaderFromSourceFile(QOpenGLShader::Fragment,
-                                         ":/res/shaders/post_processor.frag");
-    post_shader->link();
-
-    auto post_fbo = std::make_shared<QOpenGLFramebufferObject>(width(), height());
-    post_processor_ = std::make_shared<PostProcessor>(post_shader, post_fbo);
-    game_level_->SetPostProcessor(post_processor_);
-
-    // texts
-    text_renderer_ = std::make_unique<TextRenderer>();
-    text_renderer_->Load("res/fonts/arial.ttf", 24);
-
-    // scheduled updates
-    render_timer_ = new QTimer(this);
-    render_timer_->setInterval(10);
-    render_timer_->start();
-    connect(render_timer_, &QTimer::timeout, this, &GameGlWidget::UpdateGame);
+    scene_->Initialize();
+    frame_clock_.start();
+
+    frame_pacer_.SetRefreshRate(QGuiApplication::primaryScreen()->refreshRate());
 }
 
 void GameGlWidget::resizeGL(int w, int h)
 {
     QOpenGLWidget::resizeGL(w, h);
 
-    sprite_renderer_->SetSize(QVector2D(w, h));
-
-    game_level_->Resize(w, h);
-
-    player_->SetPos(QVector2D(((float)w - kPlayerSize.x()) / 2, (float)h - kPlayerSize.y()));
-    sphere_->SetPos(QVector2D(player_->Pos().x() + (kPlayerSize.x() - 2 * sphere_->Radius()) / 2.0f,
-                              (float)h - kPlayerSize.y() - 2 * sphere_->Radius()));
-
-    particle_generator_->Resize(w, h);
-    text_renderer_->Resize(w, h);
-
-    post_processor_->SetFbo(std::make_shared<QOpenGLFramebufferObject>(w, h));
+    scene_->Resize(w, h);
 }
 
 void GameGlWidget::paintGL()
 {
-    post_processor_->BeginProcessor();
+    // Qt may have touched the GL state since the last frame.
+    Singleton<GlStateCache>::Instance()->BeginFrame();
 
-    sprite_renderer_->Draw(bg_tex_, QVector2D(0.0f, 0.0f), QVector2D(width(), height()), 0.0f,
-                           QVector3D(1.0f, 1.0f, 1.0f));
+    AdvanceSimulation();
 
-    game_level_->Draw(sprite_renderer_);
-    player_->Draw(sprite_renderer_);
-    particle_generator_->Draw();
-    sphere_->Draw(sprite_renderer_);
-    powerup_manager_->Draw(sprite_renderer_);
+    scene_->Render(defaultFramebufferObject());
 
-    post_processor_->EndProcessor();
-    post_processor_->Draw();
-
-    game_state_->Draw(text_renderer_);
+    if (is_overlay_visible_) {
+        DrawOverlay();
+    }
 }
 
 void GameGlWidget::keyPressEvent(QKeyEvent* event)
 {
     QOpenGLWidget::keyPressEvent(event);
 
-    auto pos = player_->Pos();
+    if (!scene_->IsLoaded())
+        return;
+
     int key = event->key();
     switch (key) {
     case Qt::Key_Space: {
-        HandleSpaceInput();
+        scene_->HandleSpaceInput();
         break;
     }
     case Qt::Key_Up:
     case Qt::Key_Down: {
-        HandleLevelMove(key);
+        scene_->HandleLevelMove(key);
         break;
     }
     case Qt::Key_Left: {
-        float x = pos.x() - kVelocity;
-        if (x <= 0) {
-            x = 0;
-        }
-        HandlePlayerMove(QVector2D(x, pos.y()));
+        scene_->MovePlayer(-kVelocity);
         break;
     }
     case Qt::Key_Right: {
-        float x = pos.x() + kVelocity;
-        if (x >= width() - player_->Size().x()) {
-            x = width() - player_->Size().x();
-        }
-        HandlePlayerMove(QVector2D(x, pos.y()));
+        scene_->MovePlayer(kVelocity);
         break;
     }
     case Qt::Key_Enter:
     case Qt::Key_Return: {
-        HandleEnterInput();
+        scene_->HandleEnterInput();
         break;
     }
     case Qt::Key_Escape: {
-        HandleEscInput();
+        if (scene_->State() == GameState::SF_WIN) {
+            qApp->quit();
+        }
+        break;
+    }
+    case Qt::Key_F2: {
+        // compare the CPU and the transform feedback particle simulation
+        scene_->SetGpuParticles(!scene_->IsGpuParticles());
+        break;
+    }
+    case Qt::Key_F3: {
+        // The stage timings are only measured while they are shown.
+        is_overlay_visible_ = !is_overlay_visible_;
+        scene_->Profiler()->SetEnabled(is_overlay_visible_);
+        break;
+    }
+    case Qt::Key_F4: {
+        int index = 0;
+        while (index < kFrameCapCount && kFrameCaps[index] != frame_pacer_.FrameCap()) {
+            ++index;
+        }
+        frame_pacer_.SetFrameCap(kFrameCaps[(index + 1) % kFrameCapCount]);
+        break;
+    }
+    case Qt::Key_F5: {
+        if (scene_->Profiler()->IsEnabled() && scene_->Profiler()->WriteStats(kGpuStatsFile)) {
+            std::cout << "GPU stage timings written to " << kGpuStatsFile << std::endl;
+        }
         break;
     }
     default:
         break;
     }
 
-    update();
+    RequestFrame();
 }
 
-void GameGlWidget::InitBgMusic()
+void GameGlWidget::showEvent(QShowEvent* event)
 {
-    auto media_player = new QMediaPlayer(this);
-    media_player->setMedia(QUrl("qrc:/res/audio/breakout.mp3"));
-    media_player->setVolume(50);
-    media_player->play();
+    QOpenGLWidget::showEvent(event);
+
+    RequestFrame();
 }
 
-void GameGlWidget::UpdateGame()
+void GameGlWidget::hideEvent(QHideEvent* event)
 {
-    current_frame_time_ = QDateTime::currentDateTime().toMSecsSinceEpoch();
-    if (last_frame_time_ == 0) {
-        last_frame_time_ = current_frame_time_;
-        return;
-    }
-
-    float dt = (float)(current_frame_time_ - last_frame_time_) / 1000.0f;
-    last_frame_time_ = current_frame_time_;
-
-    sphere_->Move(dt, width(), height());
-    DoCollision();
-
-    float offset = sphere_->Radius() / 2.0f;
-    particle_generator_->Update(dt, 2, sphere_.get(), QVector2D(offset, offset));
-
-    powerup_manager_->Update(dt, width(), height(),
-                             std::bind(&GameGlWidget::OnDeactivatePowerUp, this, std::placeholders::_1));
-
-    post_processor_->Update(dt);
+    QOpenGLWidget::hideEvent(event);
 
-    if (game_level_->IsCompleted()) {
-        ResetState(GameState::SF_WIN);
-    }
-
-    update();
+    // Minimized or hidden, stop rendering until the widget is shown again.
+    frame_timer_->stop();
+    frame_pacer_.Pause();
+    is_idle_ = true;
 }
 
-void GameGlWidget::DoCollision()
+void GameGlWidget::InitBgMusic()
 {
-    if (!sphere_->IsStuck()) {
-        // The sphere collides with the bricks.
-        game_level_->DoCollision(sphere_.get(), std::bind(&PowerUpManager::SpawnPowerUp,
-                                                          powerup_manager_, std::placeholders::_1));
-
-        // The sphere collides with the player.
-        if (CollisionHelper::CheckCollision(sphere_.get(), player_.get())) {
-            float player_center_x = player_->Pos().x() + player_->Size().x() / 2;
-
-            float distance = sphere_->Pos().x() + sphere_->Radius() - player_center_x;
-            float percentage = distance / (player_->Size().x() / 2);
-
-            float strength = 2.0f;
-            QVector2D old_velocity = sphere_->Velocity();
-
-            QVector2D velocity;
-            velocity.setX(sphere_->DefaultVelocity().x() * percentage * strength);
-            velocity.setY(-old_velocity.y());
-
-            // Keep the speed size, only change direction.
-            velocity = velocity.normalized() * old_velocity.length();
-            sphere_->SetVelocity(velocity);
-            sphere_->SetStuck(sphere_->IsSticky());
-
-            Singleton<AudioManager>::Instance()->Play(":/res/audio/bleep_player.wav");
-        }
-    }
-
-    // The player collides with the powerups.
-    powerup_manager_->DoCollision(player_.get(), std::bind(&GameGlWidget::OnActivatePowerUp, this,
-                                                           std::placeholders::_1));
-
-    CheckSpherePos();
+    auto media_player = new QMediaPlayer(this);
+    media_player->setMedia(QUrl("qrc:/res/audio/breakout.mp3"));
+    media_player->setVolume(50);
+    media_player->play();
 }
 
-void GameGlWidget::HandleLevelMove(int key)
+void GameGlWidget::OnFrameSwapped()
 {
-    if (game_state_->State() != GameState::SF_MENU)
+    frame_pacer_.FrameSwapped();
+
+    int max_fps = 0;
+    switch (CurrentPaceMode()) {
+    case PM_IDLE: {
+        // Keep the last frame on screen, input wakes the loop again.
+        frame_pacer_.Pause();
+        is_idle_ = true;
         return;
+    }
+    case PM_AMBIENT:
+        max_fps = kAmbientFps;
+        break;
+    case PM_BACKGROUND:
+        max_fps = kBackgroundFps;
+        break;
+    default:
+        break;
+    }
 
-    if (key == Qt::Key_Up) {
-        game_level_->PreviousLevel();
+    int delay_ms = frame_pacer_.DelayToNextFrameMs(max_fps);
+    if (delay_ms > 0) {
+        frame_timer_->start(delay_ms);
     } else {
-        game_level_->NextLevel();
+        update();
     }
 }
 
-void GameGlWidget::HandlePlayerMove(const QVector2D& pos)
+GameGlWidget::PaceMode GameGlWidget::CurrentPaceMode()
 {
-    if (game_state_->State() == GameState::SF_MENU || game_state_->State() == GameState::SF_WIN)
-        return;
+    if (!isVisible())
+        return PM_IDLE;
 
-    player_->SetPos(pos);
+    auto window_handle = window()->windowHandle();
+    if (window_handle && !window_handle->isExposed())
+        return PM_BACKGROUND;
 
-    if (sphere_->IsStuck()) {
-        sphere_->SetPos(QVector2D(player_->Pos().x() + (kPlayerSize.x() - 2 * sphere_->Radius()) / 2.0f,
-                                  (float)height() - kPlayerSize.y() - 2 * sphere_->Radius()));
-    }
-}
+    if (is_overlay_visible_ || scene_->IsMoving())
+        return PM_FULL;
 
-void GameGlWidget::HandleEnterInput()
-{
-    if (game_state_->State() == GameState::SF_MENU) {
-        ResetState(GameState::SF_ACTIVE);
-    } else if (game_state_->State() == GameState::SF_WIN) {
-        ResetState(GameState::SF_MENU);
-    }
-}
+    if (scene_->HasAmbientEffect())
+        return PM_AMBIENT;
 
-void GameGlWidget::HandleSpaceInput()
-{
-    if (game_state_->State() == GameState::SF_MENU || game_state_->State() == GameState::SF_WIN)
-        return;
-
-    sphere_->SetStuck(false);
-    sphere_->SetSticky(false);
+    return PM_IDLE;
 }
 
-void GameGlWidget::HandleEscInput()
+void GameGlWidget::RequestFrame()
 {
-    if (game_state_->State() != GameState::SF_WIN)
+    if (!is_idle_)
         return;
 
-    qApp->quit();
+    update();
 }
 
-void GameGlWidget::CheckSpherePos()
+void GameGlWidget::DrawOverlay()
 {
-    // bottom border
-    float sphere_bottom = sphere_->Pos().y() + 2 * sphere_->Radius();
-    if (sphere_bottom >= height()) {
-        player_->Reset(
-            QVector2D(((float)width() - kPlayerSize.x()) / 2, (float)height() - kPlayerSize.y()));
-        player_->SetSize(kPlayerSize);
-
-        sphere_->Reset(QVector2D(player_->Pos().x() + (kPlayerSize.x() - 2 * sphere_->Radius()) / 2.0f,
-                                 (float)height() - kPlayerSize.y() - 2 * sphere_->Radius()));
-
-        game_state_->SetLives(game_state_->Lives() - 1);
-        if (game_state_->Lives() == 0) {
-            ResetState(GameState::SF_MENU);
-        }
+    auto pacing = frame_pacer_.CalcStats();
+    auto gl_stats = Singleton<GlStateCache>::Instance()->LastFrameStats();
+
+    std::ostringstream lines[3];
+    lines[0] << std::fixed << std::setprecision(1) << "fps " << pacing.fps << "  frame "
+             << pacing.avg_ms << " ms (" << pacing.min_ms << " - " << pacing.max_ms << ")";
+    lines[1] << std::fixed << std::setprecision(2) << "jitter " << pacing.jitter_ms
+             << " ms  missed " << pacing.missed << "  cap ";
+    if (frame_pacer_.FrameCap() > 0) {
+        lines[1] << frame_pacer_.FrameCap();
+    } else {
+        lines[1] << "vsync";
     }
-}
-
-void GameGlWidget::ResetState(GameState::StateFlag state)
-{
-    if (state == game_state_->State())
-        return;
+    lines[2] << "gl calls " << gl_stats.issued << "  elided " << gl_stats.elided
+             << "  sprite draws " << scene_->SpriteDrawCalls();
 
-    game_state_->SetState(state);
-    game_state_->SetLives(3);
-    game_level_->Load(0);
-
-    post_processor_->SetShake(false);
-    post_processor_->SetConfuse(false);
-    powerup_manager_->Clear();
-
-    sphere_->SetVelocity(sphere_->DefaultVelocity());
-    sphere_->SetPassThrough(false);
-    sphere_->SetSticky(false);
-    sphere_->SetStuck(true);
-    player_->SetColor(QVector3D(1.0f, 1.0f, 1.0f));
-
-    switch (state) {
-    case GameState::SF_MENU: {
-        post_processor_->SetChaos(false);
-
-        player_->SetSize(kPlayerSize);
-        player_->SetPos(
-            QVector2D(((float)width() - kPlayerSize.x()) / 2, (float)height() - kPlayerSize.y()));
-
-    } break;
-    case GameState::SF_WIN: {
-        post_processor_->SetChaos(true);
-    } break;
-    default:
-        break;
+    std::vector<std::string> texts;
+    for (auto& line : lines) {
+        texts.emplace_back(line.str());
     }
 
-    sphere_->SetPos(QVector2D(player_->Pos().x() + (kPlayerSize.x() - 2 * sphere_->Radius()) / 2.0f,
-                              (float)height() - kPlayerSize.y() - 2 * sphere_->Radius()));
-}
-
-void GameGlWidget::OnActivatePowerUp(PowerUp::Type type)
-{
-    Singleton<AudioManager>::Instance()->Play(":/res/audio/powerup.wav");
-
-    switch (type) {
-    case PowerUp::T_SPEED:
-        sphere_->SetVelocity(sphere_->Velocity() * 1.2f);
-        break;
-    case PowerUp::T_STICKY:
-        sphere_->SetSticky(true);
-        player_->SetColor(QVector3D(1.0f, 0.5f, 1.0f));
-        break;
-    case PowerUp::T_PASS_THROUGH:
-        sphere_->SetPassThrough(true);
-        break;
-    case PowerUp::T_PAD_SIZE_INCREASE:
-        player_->SetSize(QVector2D(player_->Size().x() + 50, player_->Size().y()));
-        break;
-    case PowerUp::T_CONFUSE:
-        post_processor_->SetConfuse(true);
-        break;
-    case PowerUp::T_CHAOS:
-        post_processor_->SetChaos(true);
-        break;
-    default:
-        break;
+    for (auto& stage : scene_->Profiler()->CalcStats()) {
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(3) << "gpu " << stage.name << "  avg "
+             << stage.avg_ms << "  p50 " << stage.p50_ms << "  p95 " << stage.p95_ms << " ms";
+        texts.emplace_back(line.str());
     }
+    scene_->DrawOverlay(texts);
 }
 
-void GameGlWidget::OnDeactivatePowerUp(PowerUp::Type type)
+void GameGlWidget::AdvanceSimulation()
 {
-    switch (type) {
-    case PowerUp::T_STICKY:
-        sphere_->SetSticky(false);
-        player_->SetColor(QVector3D(1.0f, 1.0f, 1.0f));
-        break;
-    case PowerUp::T_PASS_THROUGH:
-        sphere_->SetPassThrough(false);
-        break;
-    case PowerUp::T_CONFUSE:
-        post_processor_->SetConfuse(false);
-        break;
-    case PowerUp::T_CHAOS:
-        post_processor_->SetChaos(false);
-        break;
-    default:
-        break;
+    qint64 now_ns = frame_clock_.nsecsElapsed();
+    if (is_idle_) {
+        // Nothing moved while the loop slept, do not replay that time.
+        last_tick_ns_ = now_ns;
+        is_idle_ = false;
     }
+
+    scene_->Advance((now_ns - last_tick_ns_) / 1e9);
+    last_tick_ns_ = now_ns;
 }
@@ -1,18 +1,14 @@
 #ifndef GAME_GL_WIDGET_H_
 #define GAME_GL_WIDGET_H_
 
+#include <QElapsedTimer>
 #include <QList>
 #include <QOpenGLFunctions_3_3_Core>
-#include <QOpenGLShaderProgram>
 #include <QOpenGLWidget>
 #include <QTimer>
 
-#include "game_level.h"
-#include "game_object.h"
-#include "game_state.h"
-#include "particle_generator.h"
-#include "sprite_renderer.h"
-#include "text_renderer.h"
+#include "frame_pacer.h"
+#include "game_scene.h"
 
 class GameGlWidget : public QOpenGLWidget, public QOpenGLFunctions_3_3_Core
 {
@@ -28,47 +24,36 @@ protected:
     void paintGL() override;
 
     void keyPressEvent(QKeyEvent* event) override;
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
 
 private:
-    void InitBgMusic();
-    void UpdateGame();
-    void DoCollision();
-    void CheckSpherePos();
-    void ResetState(GameState::StateFlag state);
-
-    // key events
-    void HandleLevelMove(int key);
-    void HandlePlayerMove(const QVector2D& pos);
-    void HandleEnterInput();
-    void HandleSpaceInput();
-    void HandleEscInput();
+    // how the next frame is scheduled once the current one is presented
+    enum PaceMode
+    {
+        PM_FULL,       // something moves, render at the display or capped rate
+        PM_AMBIENT,    // only a time-driven effect changes the frame
+        PM_BACKGROUND, // on screen but not exposed
+        PM_IDLE        // nothing changes, wait for input
+    };
 
-    // callbacks
-    void OnActivatePowerUp(PowerUp::Type type);
-    void OnDeactivatePowerUp(PowerUp::Type type);
+    void InitBgMusic();
+    void OnFrameSwapped();
+    PaceMode CurrentPaceMode();
+    void RequestFrame();
+    void DrawOverlay();
+    void AdvanceSimulation();
 
 private:
-    QTimer* render_timer_;
-    qint64 last_frame_time_ = 0;
-    qint64 current_frame_time_;
-
-    std::unique_ptr<GameState> game_state_;
-    std::shared_ptr<TextRenderer> text_renderer_;
-
-    std::unique_ptr<GameLevel> game_level_;
-    std::unique_ptr<GameObject> player_;
-    std::unique_ptr<SphereObject> sphere_;
-
-    std::shared_ptr<SpriteRenderer> sprite_renderer_;
-
-    std::shared_ptr<QOpenGLTexture> bg_tex_;
-    std::shared_ptr<QOpenGLTexture> paddle_tex_;
-    std::shared_ptr<QOpenGLTexture> sphere_tex_;
+    QTimer* frame_timer_;
+    FramePacer frame_pacer_;
+    bool is_overlay_visible_ = false;
+    bool is_idle_ = false;
 
-    std::shared_ptr<QOpenGLShaderProgram> particle_shader_;
-    std::shared_ptr<ParticleGenerator> particle_generator_;
+    // wall time fed to the scene's fixed step simulation
+    QElapsedTimer frame_clock_;
+    qint64 last_tick_ns_ = 0;
 
-    std::shared_ptr<PostProcessor> post_processor_;
-    std::shared_ptr<PowerUpManager> powerup_manager_;
+    std::unique_ptr<GameScene> scene_;
 };
 #endif
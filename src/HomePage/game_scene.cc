@@ -0,0 +1,471 @@
+#include "game_scene.h"
+
+#include <QOpenGLTexture>
+#include <algorithm>
+#include <ctime>
+
+#include "audio_manager.h"
+#include "gl_state_cache.h"
+#include "resource_manager.h"
+#include "shader_cache.h"
+
+struct SpriteStyle
+{
+    const char* sprite_name;
+    QVector3D color;
+};
+
+// Indexed by GameLevel::TileValue.
+static const SpriteStyle kBrickStyles[GameLevel::TV_COUNT] = {
+    {nullptr, QVector3D(0.0f, 0.0f, 0.0f)},         // TV_NON_BRICK
+    {"block_solid", QVector3D(0.8f, 0.8f, 0.7f)}, // TV_HARD_BRICK
+    {"block", QVector3D(1.0f, 1.0f, 1.0f)},       // TV_STYLE_1_BRICK
+    {"block", QVector3D(0.2f, 0.6f, 1.0f)},       // TV_STYLE_2_BRICK
+    {"block", QVector3D(0.0f, 0.7f, 0.0f)},       // TV_STYLE_3_BRICK
+    {"block", QVector3D(0.8f, 0.8f, 0.4f)},       // TV_STYLE_4_BRICK
+    {"block", QVector3D(1.0f, 0.5f, 0.0f)}        // TV_STYLE_5_BRICK
+};
+
+// Indexed by PowerUp::Type.
+static const SpriteStyle kPowerUpStyles[] = {
+    {"powerup_speed", QVector3D(0.5f, 0.5f, 1.0f)},       // T_SPEED
+    {"powerup_sticky", QVector3D(1.0f, 0.5f, 1.0f)},      // T_STICKY
+    {"powerup_passthrough", QVector3D(0.5f, 1.0f, 0.5f)}, // T_PASS_THROUGH
+    {"powerup_increase", QVector3D(1.0f, 0.6f, 0.4f)},    // T_PAD_SIZE_INCREASE
+    {"powerup_confuse", QVector3D(1.0f, 0.3f, 0.3f)},     // T_CONFUSE
+    {"powerup_chaos", QVector3D(0.9f, 0.25f, 0.25f)},     // T_CHAOS
+    {"powerup_multiball", QVector3D(0.4f, 0.9f, 1.0f)}    // T_MULTI_BALL
+};
+static constexpr int kPowerUpStyleCount = sizeof(kPowerUpStyles) / sizeof(kPowerUpStyles[0]);
+
+static const QVector3D kPlayerColor(1.0f, 1.0f, 1.0f);
+static const QVector3D kStickyPlayerColor(1.0f, 0.5f, 1.0f);
+
+// Longer stalls (debugger, window drag) are dropped instead of replayed.
+constexpr double kMaxFrameTime = 0.25;
+constexpr float kParticlesPerSecond = 200.0f;
+// Textures uploaded per frame while loading, so the loading screen keeps its frame rate.
+constexpr int kUploadsPerFrame = 2;
+
+GameScene::GameScene()
+    : w_(0)
+    , h_(0)
+    , accumulator_(0.0)
+    , sim_time_(0.0)
+    , render_alpha_(1.0f)
+    , particle_carry_(0.0f)
+    , is_loaded_(false)
+    , simulation_(std::make_unique<Simulation>((unsigned int)time(nullptr)))
+    , has_inputs_(false)
+    , hud_(std::make_unique<Hud>())
+    , brick_layout_revision_(-1)
+{}
+
+GameScene::~GameScene()
+{
+    Singleton<ResourceManager>::ReleaseInstance();
+    Singleton<GlStateCache>::ReleaseInstance();
+    Singleton<ShaderCache>::ReleaseInstance();
+}
+
+void GameScene::Initialize()
+{
+    initializeOpenGLFunctions();
+
+    // Decoded on the thread pool while the programs below compile, see CreateObjects().
+    Singleton<ResourceManager>::Instance()->LoadAsync(
+        ":/res/images", {{"background", ":/res/images/background.jpg", false}});
+
+    // projection and time shared by all programs
+    frame_uniforms_ = std::make_unique<FrameUniforms>();
+
+    // sprites
+    auto shader_cache = Singleton<ShaderCache>::Instance();
+    QByteArray sprite_fragment = ShaderCache::ReadSource(":/res/shaders/sprite.frag");
+
+    auto shader_program = std::make_shared<QOpenGLShaderProgram>();
+    shader_cache->Build(
+        shader_program.get(), "sprite",
+        {{QOpenGLShader::Vertex, ShaderCache::ReadSource(":/res/shaders/sprite.vert")},
+         {QOpenGLShader::Fragment, sprite_fragment}});
+    frame_uniforms_->Attach(shader_program->programId());
+
+    sprite_batch_ = std::make_shared<SpriteBatch>(shader_program);
+
+    // bricks
+    brick_shader_ = std::make_shared<QOpenGLShaderProgram>();
+    shader_cache->Build(
+        brick_shader_.get(), "brick",
+        {{QOpenGLShader::Vertex, ShaderCache::ReadSource(":/res/shaders/brick.vert")},
+         {QOpenGLShader::Fragment, sprite_fragment}});
+    frame_uniforms_->Attach(brick_shader_->programId());
+
+    // background and bricks, redrawn only when the level changes
+    static_layer_ = std::make_unique<StaticLayer>();
+
+    // particles
+    particle_shader_ = std::make_shared<QOpenGLShaderProgram>();
+    shader_cache->Build(
+        particle_shader_.get(), "particle",
+        {{QOpenGLShader::Vertex, ShaderCache::ReadSource(":/res/shaders/particle.vert")},
+         {QOpenGLShader::Fragment, ShaderCache::ReadSource(":/res/shaders/particle.frag")}});
+    frame_uniforms_->Attach(particle_shader_->programId());
+
+    // post-process, builds its own shader variants
+    auto post_fbo = std::make_shared<QOpenGLFramebufferObject>(1, 1);
+    post_processor_ = std::make_shared<PostProcessor>(post_fbo, *frame_uniforms_);
+
+    // texts
+    text_renderer_ = std::make_unique<TextRenderer>();
+    text_renderer_->Load("res/fonts/arial.ttf", 24);
+
+    gpu_profiler_ = std::make_unique<GpuProfiler>(
+        std::vector<std::string>{"scene", "particles", "sprites", "post", "text"});
+
+    shader_cache->PrintStats();
+}
+
+void GameScene::Resize(int w, int h)
+{
+    w_ = w;
+    h_ = h;
+
+    frame_uniforms_->SetScreenSize(w, h);
+
+    simulation_->Resize(w, h);
+
+    if (is_loaded_) {
+        SyncBrickField();
+    }
+
+    text_renderer_->Resize(w, h);
+
+    static_layer_->Resize(w, h);
+
+    post_processor_->SetFbo(std::make_shared<QOpenGLFramebufferObject>(w, h));
+}
+
+void GameScene::Seed(unsigned int seed)
+{
+    simulation_->Seed(seed);
+}
+
+void GameScene::SetLaunchCount(int count)
+{
+    simulation_->SetLaunchCount(count);
+}
+
+void GameScene::WaitLoaded()
+{
+    if (is_loaded_)
+        return;
+
+    Singleton<ResourceManager>::Instance()->WaitLoaded();
+    CreateObjects();
+}
+
+void GameScene::Advance(double frame_time)
+{
+    if (!is_loaded_)
+        return;
+
+    frame_time = std::min(frame_time, kMaxFrameTime);
+    sim_time_ += frame_time;
+
+    accumulator_ += frame_time;
+    while (accumulator_ >= Simulation::kStep) {
+        StepSimulation();
+        accumulator_ -= Simulation::kStep;
+    }
+
+    // Draw between the last two steps so motion stays smooth at any paint rate.
+    render_alpha_ = (float)(accumulator_ / Simulation::kStep);
+}
+
+void GameScene::Render(GLuint target_fbo)
+{
+    if (!is_loaded_) {
+        if (!Singleton<ResourceManager>::Instance()->Upload(kUploadsPerFrame)) {
+            RenderLoading();
+            return;
+        }
+        CreateObjects();
+    }
+
+    gpu_profiler_->BeginFrame();
+    frame_uniforms_->SetTime((float)sim_time_);
+
+    gpu_profiler_->BeginStage(GS_SCENE);
+    UpdateStaticLayer(target_fbo);
+
+    post_processor_->BeginProcessor();
+
+    sprite_batch_->Begin();
+    static_layer_->Draw(sprite_batch_);
+    DrawObject(simulation_->Player(), player_sprite_,
+               simulation_->IsStickyPlayer() ? kStickyPlayerColor : kPlayerColor);
+
+    // The particles use their own shader, submit the sprites queued so far first.
+    sprite_batch_->Flush();
+    gpu_profiler_->EndStage();
+
+    gpu_profiler_->BeginStage(GS_PARTICLES);
+    particle_generator_->Draw();
+    gpu_profiler_->EndStage();
+
+    gpu_profiler_->BeginStage(GS_SPRITES);
+    for (auto& sphere : simulation_->Spheres()) {
+        DrawObject(sphere, sphere_sprite_, QVector3D(1.0f, 1.0f, 1.0f));
+    }
+    DrawPowerUps();
+    sprite_batch_->End();
+    gpu_profiler_->EndStage();
+
+    // Without an effect the frame is already in target_fbo, no post stage to time.
+    if (!post_processor_->IsBypassed()) {
+        gpu_profiler_->BeginStage(GS_POST);
+        post_processor_->EndProcessor(target_fbo);
+        post_processor_->Draw();
+        gpu_profiler_->EndStage();
+    }
+
+    gpu_profiler_->BeginStage(GS_TEXT);
+    hud_->Draw(text_renderer_, simulation_->State());
+    gpu_profiler_->EndStage();
+
+    gpu_profiler_->EndFrame();
+}
+
+void GameScene::DrawOverlay(const std::vector<std::string>& lines)
+{
+    float scale = 0.6f;
+    float line_height = text_renderer_->FontHeight() * scale + 4.0f;
+    float y = h_ - text_renderer_->FontHeight() - line_height;
+    for (auto& line : lines) {
+        text_renderer_->RenderText(line, 5.0f, y, scale, glm::vec3(0.9f, 0.9f, 0.2f));
+        y -= line_height;
+    }
+    text_renderer_->Flush();
+}
+
+void GameScene::HandleLevelMove(int key)
+{
+    inputs_.level_step += key == Qt::Key_Up ? -1 : 1;
+    has_inputs_ = true;
+}
+
+void GameScene::MovePlayer(float dx)
+{
+    inputs_.player_dx += dx;
+    has_inputs_ = true;
+}
+
+void GameScene::HandleEnterInput()
+{
+    inputs_.is_enter = true;
+    has_inputs_ = true;
+}
+
+void GameScene::HandleSpaceInput()
+{
+    inputs_.is_launch = true;
+    has_inputs_ = true;
+}
+
+void GameScene::FollowBall(float max_dx)
+{
+    MovePlayer(simulation_->FollowBall(max_dx));
+}
+
+void GameScene::SetGpuParticles(bool enable)
+{
+    particle_generator_->SetGpuSimulation(enable);
+}
+
+bool GameScene::IsMoving()
+{
+    // keep the frames coming until the uploads are done
+    if (!is_loaded_)
+        return true;
+
+    // queued input waits for the next step
+    return has_inputs_ || simulation_->IsMoving() || !particle_generator_->IsIdle();
+}
+
+bool GameScene::HasAmbientEffect()
+{
+    return post_processor_->IsAnimated();
+}
+
+void GameScene::CreateObjects()
+{
+    auto res_manager = Singleton<ResourceManager>::Instance();
+
+    bg_tex_ = res_manager->Texture("background", ":/res/images/background.jpg", false);
+
+    player_sprite_ = res_manager->Sprite("paddle");
+    sphere_sprite_ = res_manager->Sprite("awesomeface");
+    for (int type = 0; type < kPowerUpStyleCount; ++type) {
+        powerup_sprites_.emplace_back(res_manager->Sprite(kPowerUpStyles[type].sprite_name));
+    }
+
+    brick_field_ = std::make_shared<BrickField>(brick_shader_);
+    for (int style = GameLevel::TV_NON_BRICK + 1; style < GameLevel::TV_COUNT; ++style) {
+        brick_field_->SetStyle(style, kBrickStyles[style].color,
+                               res_manager->Sprite(kBrickStyles[style].sprite_name));
+    }
+    SyncBrickField();
+
+    particle_generator_ =
+        std::make_shared<ParticleGenerator>(particle_shader_, res_manager->Sprite("particle"));
+
+    is_loaded_ = true;
+}
+
+void GameScene::RenderLoading()
+{
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    text_renderer_->RenderText("Loading...", 5.0f, 5.0f, 1.0f, glm::vec3(1.0f, 1.0f, 1.0f));
+    text_renderer_->Flush();
+}
+
+void GameScene::StepSimulation()
+{
+    simulation_->Step(inputs_);
+    inputs_ = Simulation::Inputs();
+    has_inputs_ = false;
+
+    HandleEvents();
+
+    // Keep the trail density independent of the step rate. A ball resting on the paddle leaves
+    // no trail, so the loop can go idle while the player waits. With several balls the trail
+    // moves from ball to ball every step, the particle count does not grow with the balls.
+    auto& spheres = simulation_->Spheres();
+    const SphereObject& sphere = spheres[simulation_->Ticks() % spheres.size()];
+    int new_particle_num = 0;
+    if (!sphere.IsStuck()) {
+        particle_carry_ += kParticlesPerSecond * Simulation::kStep;
+        new_particle_num = (int)particle_carry_;
+        particle_carry_ -= new_particle_num;
+    }
+
+    glm::vec2 emitter = sphere.Pos() + sphere.Radius() / 2.0f;
+    particle_generator_->Update(Simulation::kStep, new_particle_num,
+                                QVector2D(emitter.x, emitter.y),
+                                QVector2D(sphere.Velocity().x, sphere.Velocity().y));
+
+    post_processor_->SetConfuse(simulation_->IsConfuse());
+    post_processor_->SetChaos(simulation_->IsChaos());
+    post_processor_->Update(Simulation::kStep);
+}
+
+void GameScene::HandleEvents()
+{
+    // A rebuilt field already leaves out the bricks destroyed in the step.
+    bool is_rebuilt = SyncBrickField();
+
+    // One sound effect plays at a time and a new one cuts the last, so with many balls only the
+    // last sound of the step is played.
+    const char* sound = nullptr;
+    for (auto& event : simulation_->Events()) {
+        switch (event.type) {
+        case Simulation::ET_BRICK_DESTROYED:
+            if (!is_rebuilt) {
+                brick_field_->Destroy(event.index);
+            }
+            sound = ":/res/audio/bleep.wav";
+            break;
+        case Simulation::ET_SOLID_HIT:
+            post_processor_->SetShake(true);
+            sound = ":/res/audio/solid.wav";
+            break;
+        case Simulation::ET_PLAYER_HIT:
+            sound = ":/res/audio/bleep_player.wav";
+            break;
+        case Simulation::ET_POWER_UP:
+            sound = ":/res/audio/powerup.wav";
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (sound) {
+        Singleton<AudioManager>::Instance()->Play(sound);
+    }
+}
+
+void GameScene::UpdateStaticLayer(GLuint target_fbo)
+{
+    const GameLevel& level = simulation_->Level();
+    if (!static_layer_->IsStale(level.Revision()))
+        return;
+
+    static_layer_->Begin();
+
+    sprite_batch_->Begin();
+    sprite_batch_->Draw(bg_tex_, QVector2D(0.0f, 0.0f), QVector2D(w_, h_), 0.0f,
+                        QVector3D(1.0f, 1.0f, 1.0f));
+
+    // The brick field uses its own shader, submit the background first.
+    sprite_batch_->Flush();
+    brick_field_->Draw();
+    sprite_batch_->End();
+
+    static_layer_->End(level.Revision(), target_fbo);
+}
+
+bool GameScene::SyncBrickField()
+{
+    const GameLevel& level = simulation_->Level();
+    if (level.LayoutRevision() == brick_layout_revision_)
+        return false;
+
+    brick_layout_revision_ = level.LayoutRevision();
+
+    brick_field_->Clear();
+    brick_field_->SetCellSize(QVector2D(level.CellSize().x, level.CellSize().y));
+
+    // same order as the bricks of the level, so the indices match
+    auto& tiles = level.Tiles();
+    int cols = tiles.empty() ? 0 : (int)tiles[0].size();
+    for (int row = 0; row < (int)tiles.size(); ++row) {
+        for (int col = 0; col < cols; ++col) {
+            if (GameLevel::IsBrick(tiles[row][col])) {
+                brick_field_->AddBrick(col, row, tiles[row][col]);
+            }
+        }
+    }
+
+    const BrickStore& bricks = level.Bricks();
+    for (int index = 0; index < bricks.Size(); ++index) {
+        if (!bricks.IsAlive(index)) {
+            brick_field_->Destroy(index);
+        }
+    }
+
+    return true;
+}
+
+void GameScene::DrawObject(const GameObject& object, const TextureRegion& sprite,
+                           const QVector3D& color)
+{
+    glm::vec2 pos = object.PrevPos() + (object.Pos() - object.PrevPos()) * render_alpha_;
+    sprite_batch_->Draw(sprite, QVector2D(pos.x, pos.y),
+                        QVector2D(object.Size().x, object.Size().y), 0.0f, color);
+}
+
+void GameScene::DrawPowerUps()
+{
+    for (auto& powerup_pair : simulation_->PowerUps().PowerUps()) {
+        for (auto& powerup : powerup_pair.second) {
+            if (powerup->IsActive())
+                continue;
+
+            int type = powerup->PowerUpType();
+            DrawObject(*powerup, powerup_sprites_[type], kPowerUpStyles[type].color);
+        }
+    }
+}
@@ -0,0 +1,195 @@
+#ifndef GAME_SCENE_H_
+#define GAME_SCENE_H_
+
+#include <QOpenGLFunctions_3_3_Core>
+#include <QOpenGLShaderProgram>
+#include <string>
+#include <vector>
+
+#include "brick_field.h"
+#include "frame_uniforms.h"
+#include "gpu_profiler.h"
+#include "hud.h"
+#include "particle_generator.h"
+#include "post_processor.h"
+#include "simulation.h"
+#include "sprite_batch.h"
+#include "static_layer.h"
+#include "text_renderer.h"
+
+/**
+ * @brief Renderer and input adapter of the Simulation. Input is queued and applied by the next
+ * step, the steps' events drive the sounds, particles and effects. It renders into whatever
+ * framebuffer is bound, so the same scene runs in GameGlWidget and headless.
+ *
+ * Initialize(), Resize() and Render() expect the GL context to be current. The textures are
+ * decoded in the background after Initialize(), Render() draws a loading screen and uploads a
+ * few of them per frame until the game objects can be created.
+ */
+class GameScene : protected QOpenGLFunctions_3_3_Core
+{
+public:
+    GameScene();
+    ~GameScene();
+
+    void Initialize();
+    void Resize(int w, int h);
+
+    /**
+     * @brief Seed of the simulation, the same seed and inputs replay the same game.
+     */
+    void Seed(unsigned int seed);
+
+    /**
+     * @brief Stress mode, balls released per launch, see Simulation::SetLaunchCount().
+     */
+    void SetLaunchCount(int count);
+
+    /**
+     * @brief Loading barrier, blocks until the textures are uploaded and the game objects exist.
+     */
+    void WaitLoaded();
+    inline bool IsLoaded();
+
+    /**
+     * @brief Run the fixed-step simulation for frame_time seconds of wall time. The rest of a
+     * step is kept and used to interpolate the next Render().
+     */
+    void Advance(double frame_time);
+
+    /**
+     * @param target_fbo Framebuffer the frame ends up in, bound when Render() is called.
+     */
+    void Render(GLuint target_fbo);
+
+    /**
+     * @brief Small text lines below the lives label, drawn on top of the frame.
+     */
+    void DrawOverlay(const std::vector<std::string>& lines);
+
+    // input, applied by the next simulation step
+    void HandleLevelMove(int key);
+    void MovePlayer(float dx);
+    void HandleEnterInput();
+    void HandleSpaceInput();
+
+    /**
+     * @brief Autoplay, moves the player towards the ball by up to max_dx.
+     */
+    void FollowBall(float max_dx);
+
+    void SetGpuParticles(bool enable);
+    inline bool IsGpuParticles();
+
+    /**
+     * @brief Something on screen moves and every frame looks different.
+     */
+    bool IsMoving();
+
+    /**
+     * @brief Only a time-driven effect changes the frame.
+     */
+    bool HasAmbientEffect();
+
+    inline GameState::StateFlag State();
+    inline int SpriteDrawCalls();
+
+    /**
+     * @brief GPU time of the Render() stages, disabled until someone asks for it.
+     */
+    inline GpuProfiler* Profiler();
+
+private:
+    // GpuProfiler stages, in the order Render() runs them
+    enum GpuStage
+    {
+        GS_SCENE,     // static layer, player
+        GS_PARTICLES,
+        GS_SPRITES,   // ball, power-ups
+        GS_POST,
+        GS_TEXT
+    };
+
+    void CreateObjects();
+    void RenderLoading();
+
+    void StepSimulation();
+    void HandleEvents();
+    void UpdateStaticLayer(GLuint target_fbo);
+
+    /**
+     * @return True if the brick field was rebuilt from the level, false if it was up to date.
+     */
+    bool SyncBrickField();
+
+    void DrawObject(const GameObject& object, const TextureRegion& sprite,
+                    const QVector3D& color);
+    void DrawPowerUps();
+
+private:
+    int w_;
+    int h_;
+
+    // fixed step simulation
+    double accumulator_;
+    double sim_time_;
+    float render_alpha_;
+    float particle_carry_;
+
+    bool is_loaded_;
+
+    std::unique_ptr<Simulation> simulation_;
+    Simulation::Inputs inputs_;
+    bool has_inputs_;
+
+    std::unique_ptr<Hud> hud_;
+    std::shared_ptr<TextRenderer> text_renderer_;
+
+    TextureRegion player_sprite_;
+    TextureRegion sphere_sprite_;
+    std::vector<TextureRegion> powerup_sprites_; // by PowerUp::Type
+
+    std::unique_ptr<FrameUniforms> frame_uniforms_;
+
+    std::shared_ptr<SpriteBatch> sprite_batch_;
+    std::shared_ptr<QOpenGLShaderProgram> brick_shader_;
+    std::shared_ptr<BrickField> brick_field_;
+    int brick_layout_revision_; // of the level the brick field was built from
+
+    std::shared_ptr<QOpenGLTexture> bg_tex_;
+    std::unique_ptr<StaticLayer> static_layer_;
+
+    std::shared_ptr<QOpenGLShaderProgram> particle_shader_;
+    std::shared_ptr<ParticleGenerator> particle_generator_;
+
+    std::shared_ptr<PostProcessor> post_processor_;
+
+    std::unique_ptr<GpuProfiler> gpu_profiler_;
+};
+
+inline bool GameScene::IsLoaded()
+{
+    return is_loaded_;
+}
+
+inline bool GameScene::IsGpuParticles()
+{
+    return particle_generator_->IsGpuSimulation();
+}
+
+inline GameState::StateFlag GameScene::State()
+{
+    return simulation_->State().State();
+}
+
+inline int GameScene::SpriteDrawCalls()
+{
+    return sprite_batch_->DrawCalls();
+}
+
+inline GpuProfiler* GameScene::Profiler()
+{
+    return gpu_profiler_.get();
+}
+
+#endif
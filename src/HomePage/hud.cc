@@ -0,0 +1,91 @@
+#include "hud.h"
+
+Hud::Hud()
+    : lives_(-1)
+    , is_labels_created_(false)
+    , lives_label_(-1)
+    , menu_labels_{-1, -1}
+    , win_labels_{-1, -1}
+    , layout_size_(0.0f)
+{}
+
+void Hud::Draw(std::shared_ptr<TextRenderer> renderer, const GameState& state)
+{
+    if (!is_labels_created_) {
+        lives_label_ = renderer->CreateText();
+        for (int i = 0; i < 2; ++i) {
+            menu_labels_[i] = renderer->CreateText();
+            win_labels_[i] = renderer->CreateText();
+        }
+        is_labels_created_ = true;
+    }
+
+    // The labels are only rebuilt when the window size or the lives change.
+    if (layout_size_ != renderer->WindowSize()) {
+        layout_size_ = renderer->WindowSize();
+        Layout(renderer);
+        lives_ = -1;
+    }
+
+    if (lives_ != state.Lives()) {
+        lives_ = state.Lives();
+
+        float scale = 1.0f;
+        renderer->SetText(lives_label_, "Lives:" + std::to_string(lives_), 0.0f,
+                          layout_size_.y - renderer->FontHeight() * scale, scale,
+                          glm::vec3(5.0f, 5.0f, 1.0f));
+    }
+
+    renderer->RenderText(lives_label_);
+
+    switch (state.State()) {
+    case GameState::SF_MENU: {
+        renderer->RenderText(menu_labels_[0]);
+        renderer->RenderText(menu_labels_[1]);
+    } break;
+    case GameState::SF_ACTIVE:
+        break;
+    case GameState::SF_WIN: {
+        renderer->RenderText(win_labels_[0]);
+        renderer->RenderText(win_labels_[1]);
+    } break;
+    default:
+        break;
+    }
+}
+
+void Hud::Layout(std::shared_ptr<TextRenderer> renderer)
+{
+    float window_w = layout_size_.x;
+    float window_h = layout_size_.y;
+
+    unsigned int font_height = renderer->FontHeight();
+
+    float scale = 1.0f;
+    float scale_factor = 0.7f;
+
+    int spacing = 5;
+    int total_text_height = (int)(font_height + spacing + font_height * scale_factor);
+    int y = (window_h - total_text_height) / 2;
+
+    std::string text = "Press UP or DOWN to select level";
+    renderer->SetText(menu_labels_[0], text,
+                      (window_w - renderer->TextWidth(text, scale_factor)) / 2, y, scale_factor,
+                      glm::vec3(0.75f));
+
+    text = "Press ENTER to start";
+    scale_factor = 1.0f;
+    renderer->SetText(menu_labels_[1], text,
+                      (window_w - renderer->TextWidth(text, scale_factor)) / 2,
+                      y + font_height * scale_factor + spacing, scale, glm::vec3(1.0f));
+
+    text = "Press ENTER to retry or ESC to quit";
+    renderer->SetText(win_labels_[0], text,
+                      (window_w - renderer->TextWidth(text, scale_factor)) / 2, y, scale_factor,
+                      glm::vec3(1.0f, 1.0f, 0.0f));
+
+    text = "You WON!!!";
+    renderer->SetText(win_labels_[1], text,
+                      (window_w - renderer->TextWidth(text, scale_factor)) / 2,
+                      y + font_height * scale_factor + spacing, scale, glm::vec3(0.0f, 1.0f, 0.0f));
+}
@@ -0,0 +1,31 @@
+#ifndef HUD_H_
+#define HUD_H_
+
+#include "game_state.h"
+#include "text_renderer.h"
+
+/**
+ * @brief Lives label and the menu and win screens, drawn for the simulation's GameState.
+ */
+class Hud
+{
+public:
+    Hud();
+    ~Hud() {}
+
+    void Draw(std::shared_ptr<TextRenderer> renderer, const GameState& state);
+
+private:
+    void Layout(std::shared_ptr<TextRenderer> renderer);
+
+private:
+    int lives_; // shown in the lives label, -1 before the first draw
+
+    bool is_labels_created_;
+    TextRenderer::TextHandle lives_label_;
+    TextRenderer::TextHandle menu_labels_[2];
+    TextRenderer::TextHandle win_labels_[2];
+    glm::vec2 layout_size_;
+};
+
+#endif
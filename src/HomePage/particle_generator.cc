@@ -2,6 +2,11 @@
 
 #include <time.h>
 
+#include <algorithm>
+#include <cstddef>
+
+#include "shader_cache.h"
+
 // clang-format off
 static float vertices[] = {
 	// vertext   // texture pos	
@@ -15,28 +20,76 @@ static float vertices[] = {
 };
 // clang-format on
 
+// Update() calls queued for the GPU between two frames; further calls merge into the last one.
+static const int kMaxPendingSteps = 16;
+// life of a freshly spawned particle, particle_update.vert spawns with the same value
+static const float kParticleLife = 1.0f;
+
 ParticleGenerator::ParticleGenerator(std::shared_ptr<QOpenGLShaderProgram> shader,
-                                     std::shared_ptr<QOpenGLTexture> texture, int num)
+                                     const TextureRegion& sprite, int num)
     : shader_(shader)
-    , texture_(texture)
+    , tex_rect_location_(shader->uniformLocation("tex_rect"))
+    , sprite_(sprite)
     , vao_(0)
+    , quad_vbo_(0)
+    , instance_vbo_(0)
     , lastUnusedIndex_(0)
+    , settle_time_(0.0f)
+    , is_gpu_simulation_(false)
+    , is_gpu_active_(false)
+    , spawn_begin_(0)
+    , current_state_(0)
+    , state_vbo_{0, 0}
+    , update_vao_{0, 0}
+    , render_vao_{0, 0}
+    , update_locations_()
+    , gl_state_(Singleton<GlStateCache>::Instance())
 {
     srand((unsigned int)time(NULL));
 
-    for (int i = 0; i < num; ++i) {
-        particles_.emplace_back(Particel());
-    }
+    particles_.resize(num);
+    instances_.reserve(num);
 
     InitRenderData();
 }
 
-void ParticleGenerator::Update(float dt, int new_particle_num, GameObject* object,
-                               const QVector2D& offset)
+ParticleGenerator::~ParticleGenerator()
+{
+    glDeleteVertexArrays(1, &vao_);
+    glDeleteBuffers(1, &quad_vbo_);
+    glDeleteBuffers(1, &instance_vbo_);
+    glDeleteVertexArrays(2, update_vao_);
+    glDeleteVertexArrays(2, render_vao_);
+    glDeleteBuffers(2, state_vbo_);
+}
+
+void ParticleGenerator::Update(float dt, int new_particle_num, const QVector2D& pos,
+                               const QVector2D& velocity)
 {
+    if (new_particle_num > 0) {
+        settle_time_ = kParticleLife;
+    } else {
+        settle_time_ = std::max(settle_time_ - dt, 0.0f);
+    }
+
+    if (is_gpu_simulation_) {
+        EmitterStep step = {dt, new_particle_num, pos, velocity * 0.1f};
+
+        if ((int)pending_steps_.size() < kMaxPendingSteps) {
+            pending_steps_.emplace_back(step);
+        } else {
+            EmitterStep& last = pending_steps_.back();
+            last.dt += step.dt;
+            last.spawn_count += step.spawn_count;
+            last.pos = step.pos;
+            last.velocity = step.velocity;
+        }
+        return;
+    }
+
     for (int i = 0; i < new_particle_num; ++i) {
         lastUnusedIndex_ = FirstUnusedParticleIndex();
-        RespawnParticles(lastUnusedIndex_, object, offset);
+        RespawnParticles(lastUnusedIndex_, pos, velocity);
     }
 
     for (auto& particle : particles_) {
@@ -51,53 +104,239 @@ void ParticleGenerator::Update(float dt, int new_particle_num, GameObject* objec
 
 void ParticleGenerator::Draw()
 {
-    glEnable(GL_BLEND);
+    if (is_gpu_simulation_ != is_gpu_active_) {
+        if (is_gpu_simulation_) {
+            if (InitGpuData()) {
+                UploadGpuState();
+            } else {
+                is_gpu_simulation_ = false;
+            }
+        } else {
+            // The GPU state is never read back, the CPU path starts over.
+            for (auto& particle : particles_) {
+                particle.life = 0.0f;
+            }
+            pending_steps_.clear();
+        }
+        is_gpu_active_ = is_gpu_simulation_;
+    }
+
+    GLsizei count = 0;
+    if (is_gpu_active_) {
+        SimulateOnGpu();
+        count = (GLsizei)particles_.size();
+    } else {
+        count = StreamCpuParticles();
+    }
+
+    if (count == 0)
+        return;
+
+    gl_state_->SetBlend(true);
+    gl_state_->BlendFunc(GL_ONE, GL_ONE); // additive, src is already multiplied by its alpha
+
+    gl_state_->UseProgram(shader_->programId());
+    shader_->setUniformValue(tex_rect_location_, sprite_.tex_rect);
+    gl_state_->BindTexture(sprite_.texture->textureId());
+
+    // Dead particles on the GPU path have faded to zero alpha and add nothing.
+    gl_state_->BindVertexArray(is_gpu_active_ ? render_vao_[current_state_] : vao_);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, count);
+}
+
+void ParticleGenerator::InitRenderData()
+{
+    initializeOpenGLFunctions();
+
+    glGenVertexArrays(1, &vao_);
+    gl_state_->BindVertexArray(vao_);
+
+    glGenBuffers(1, &quad_vbo_);
+    glBindBuffer(GL_ARRAY_BUFFER, quad_vbo_);
+
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(float) * 4, nullptr);
+
+    // per-particle attributes, refilled every frame
+    glGenBuffers(1, &instance_vbo_);
+    glBindBuffer(GL_ARRAY_BUFFER, instance_vbo_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(ParticleInstance) * particles_.size(), nullptr,
+                 GL_STREAM_DRAW);
+
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), nullptr);
+    glVertexAttribDivisor(1, 1);
+
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance),
+                          (void*)(sizeof(float) * 2));
+    glVertexAttribDivisor(2, 1);
+
+    gl_state_->BindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
 
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE); // color = src * src_a + dest * 1
+void ParticleGenerator::SetGpuSimulation(bool enable)
+{
+    is_gpu_simulation_ = enable;
+}
 
-    shader_->bind();
+int ParticleGenerator::StreamCpuParticles()
+{
+    instances_.clear();
     for (auto& particle : particles_) {
         if (particle.life <= 0.0f)
             continue;
 
-        shader_->setUniformValue("pos", particle.pos);
-        shader_->setUniformValue("color", particle.color);
+        ParticleInstance instance = {
+            {particle.pos.x(), particle.pos.y()},
+            {particle.color.x(), particle.color.y(), particle.color.z(), particle.color.w()}};
+        instances_.emplace_back(instance);
+    }
+
+    if (instances_.empty())
+        return 0;
 
-        texture_->bind(0);
+    // Orphan the buffer so the driver does not stall on the previous frame.
+    glBindBuffer(GL_ARRAY_BUFFER, instance_vbo_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(ParticleInstance) * particles_.size(), nullptr,
+                 GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(ParticleInstance) * instances_.size(),
+                    instances_.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return (int)instances_.size();
+}
 
-        glBindVertexArray(vao_);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+bool ParticleGenerator::InitGpuData()
+{
+    if (update_shader_)
+        return update_shader_->isLinked();
+
+    // The captured outputs have to be declared before linking.
+    update_shader_ = std::make_unique<QOpenGLShaderProgram>();
+    bool is_linked = Singleton<ShaderCache>::Instance()->Build(
+        update_shader_.get(), "particle_update",
+        {{QOpenGLShader::Vertex, ShaderCache::ReadSource(":/res/shaders/particle_update.vert")}},
+        {"out_pos", "out_velocity", "out_color", "out_life"});
+    if (!is_linked)
+        return false;
+
+    update_locations_.dt = update_shader_->uniformLocation("dt");
+    update_locations_.particle_count = update_shader_->uniformLocation("particle_count");
+    update_locations_.spawn_begin = update_shader_->uniformLocation("spawn_begin");
+    update_locations_.spawn_count = update_shader_->uniformLocation("spawn_count");
+    update_locations_.emitter_pos = update_shader_->uniformLocation("emitter_pos");
+    update_locations_.emitter_velocity = update_shader_->uniformLocation("emitter_velocity");
+    update_locations_.seed = update_shader_->uniformLocation("seed");
+
+    glGenBuffers(2, state_vbo_);
+    glGenVertexArrays(2, update_vao_);
+    glGenVertexArrays(2, render_vao_);
+
+    GLsizei stride = sizeof(ParticleState);
+    for (int i = 0; i < 2; ++i) {
+        glBindBuffer(GL_ARRAY_BUFFER, state_vbo_[i]);
+        glBufferData(GL_ARRAY_BUFFER, stride * particles_.size(), nullptr, GL_DYNAMIC_COPY);
+
+        // simulation input, the whole particle state
+        gl_state_->BindVertexArray(update_vao_[i]);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride,
+                              (void*)offsetof(ParticleState, pos));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride,
+                              (void*)offsetof(ParticleState, velocity));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride,
+                              (void*)offsetof(ParticleState, color));
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride,
+                              (void*)offsetof(ParticleState, life));
+
+        // drawing, same layout as the CPU instance buffer
+        gl_state_->BindVertexArray(render_vao_[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, quad_vbo_);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(float) * 4, nullptr);
+
+        glBindBuffer(GL_ARRAY_BUFFER, state_vbo_[i]);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride,
+                              (void*)offsetof(ParticleState, pos));
+        glVertexAttribDivisor(1, 1);
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride,
+                              (void*)offsetof(ParticleState, color));
+        glVertexAttribDivisor(2, 1);
     }
 
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // blend default
+    gl_state_->BindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return true;
 }
 
-void ParticleGenerator::Resize(int w, int h)
+void ParticleGenerator::UploadGpuState()
 {
-    QMatrix4x4 proj_mat;
-    proj_mat.ortho(0.0f, (float)w, (float)h, 0.0f, -1.0f, 1.0f);
-    shader_->bind();
-    shader_->setUniformValue("proj_mat", proj_mat);
+    std::vector<ParticleState> states(particles_.size());
+    for (size_t i = 0; i < particles_.size(); ++i) {
+        const Particel& particle = particles_[i];
+        float alpha = particle.life > 0.0f ? particle.color.w() : 0.0f;
+        states[i] = {{particle.pos.x(), particle.pos.y()},
+                     {particle.velocity.x(), particle.velocity.y()},
+                     {particle.color.x(), particle.color.y(), particle.color.z(), alpha},
+                     particle.life};
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, state_vbo_[current_state_]);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(ParticleState) * states.size(), states.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    spawn_begin_ = lastUnusedIndex_;
 }
 
-void ParticleGenerator::InitRenderData()
+void ParticleGenerator::SimulateOnGpu()
 {
-    initializeOpenGLFunctions();
+    if (pending_steps_.empty())
+        return;
 
-    glGenVertexArrays(1, &vao_);
-    glBindVertexArray(vao_);
+    int count = (int)particles_.size();
 
-    quint32 vbo;
-    glGenBuffers(1, &vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    gl_state_->UseProgram(update_shader_->programId());
+    update_shader_->setUniformValue(update_locations_.particle_count, count);
 
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glEnable(GL_RASTERIZER_DISCARD);
 
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(float) * 4, nullptr);
+    for (const auto& step : pending_steps_) {
+        int spawn_count = std::min(step.spawn_count, count);
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+        update_shader_->setUniformValue(update_locations_.dt, step.dt);
+        update_shader_->setUniformValue(update_locations_.spawn_begin, spawn_begin_);
+        update_shader_->setUniformValue(update_locations_.spawn_count, spawn_count);
+        update_shader_->setUniformValue(update_locations_.emitter_pos, step.pos);
+        update_shader_->setUniformValue(update_locations_.emitter_velocity, step.velocity);
+        update_shader_->setUniformValue(update_locations_.seed, (GLuint)rand());
+
+        // read the current state, capture the next one into the other buffer
+        gl_state_->BindVertexArray(update_vao_[current_state_]);
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, state_vbo_[1 - current_state_]);
+
+        glBeginTransformFeedback(GL_POINTS);
+        glDrawArrays(GL_POINTS, 0, count);
+        glEndTransformFeedback();
+
+        current_state_ = 1 - current_state_;
+        spawn_begin_ = (spawn_begin_ + spawn_count) % count;
+    }
+
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    gl_state_->BindVertexArray(0);
+    glDisable(GL_RASTERIZER_DISCARD);
+
+    pending_steps_.clear();
 }
 
 int ParticleGenerator::FirstUnusedParticleIndex()
@@ -117,15 +356,14 @@ int ParticleGenerator::FirstUnusedParticleIndex()
     return 0;
 }
 
-void ParticleGenerator::RespawnParticles(int index, GameObject* object, const QVector2D& offset)
+void ParticleGenerator::RespawnParticles(int index, const QVector2D& pos,
+                                         const QVector2D& velocity)
 {
     float color_value = (rand() % 50) / 100.0f + 0.5f;
     particles_[index].color = QVector4D(color_value, color_value, color_value, 1.0f);
-    particles_[index].life = 1.0f;
+    particles_[index].life = kParticleLife;
 
-    if (auto sphere = dynamic_cast<SphereObject*>(object)) {
-        float rand_value = (rand() % 100 - 50) / 10.0f;
-        particles_[index].pos = object->Pos() + QVector2D(rand_value, rand_value) + offset;
-        particles_[index].velocity = sphere->Velocity() * 0.1f;
-    }
+    float rand_value = (rand() % 100 - 50) / 10.0f;
+    particles_[index].pos = pos + QVector2D(rand_value, rand_value);
+    particles_[index].velocity = velocity * 0.1f;
 }
@@ -1,11 +1,14 @@
 #ifndef PARTICLE_GENERATOR_H_
 #define PARTICLE_GENERATOR_H_
 
+#include <QOpenGLFunctions_3_3_Core>
+#include <QOpenGLShaderProgram>
 #include <QVector2D>
 #include <QVector4D>
 #include <vector>
 
-#include "game_object.h"
+#include "gl_state_cache.h"
+#include "texture_atlas.h"
 
 struct Particel
 {
@@ -15,29 +18,120 @@ struct Particel
     float life = 1.0f;
 };
 
+/**
+ * @brief Ball trail particles. Live particles are streamed to the GPU once per frame and drawn
+ * with one instanced call, so the budget can grow far beyond the default.
+ *
+ * With GPU simulation enabled the particle state lives in two buffers that are stepped with
+ * transform feedback. Update() only queues the emitter parameters, the steps run in Draw().
+ */
 class ParticleGenerator : protected QOpenGLFunctions_3_3_Core
 {
 public:
     ParticleGenerator(std::shared_ptr<QOpenGLShaderProgram> shader,
-                      std::shared_ptr<QOpenGLTexture> texture, int num = 500);
+                      const TextureRegion& sprite, int num = 500);
+    ~ParticleGenerator();
 
-    void Update(float dt, int new_particle_num, GameObject* object, const QVector2D& offset);
+    /**
+     * @brief Step the particles and emit new ones at pos, drifting with a tenth of velocity.
+     */
+    void Update(float dt, int new_particle_num, const QVector2D& pos, const QVector2D& velocity);
     void Draw();
 
-    void Resize(int w, int h);
+    /**
+     * @brief Switch between the CPU and the transform feedback simulation. Takes effect on the
+     * next Draw(), where a GL context is current.
+     */
+    void SetGpuSimulation(bool enable);
+    inline bool IsGpuSimulation();
+
+    /**
+     * @brief True once every particle spawned so far has died, nothing is left to draw.
+     */
+    inline bool IsIdle();
 
 private:
+    struct ParticleInstance
+    {
+        float pos[2];
+        float color[4];
+    };
+
+    struct ParticleState
+    {
+        float pos[2];
+        float velocity[2];
+        float color[4];
+        float life;
+    };
+
+    // update program uniforms, resolved once after linking
+    struct UpdateLocations
+    {
+        int dt;
+        int particle_count;
+        int spawn_begin;
+        int spawn_count;
+        int emitter_pos;
+        int emitter_velocity;
+        int seed;
+    };
+
+    struct EmitterStep
+    {
+        float dt;
+        int spawn_count;
+        QVector2D pos;
+        QVector2D velocity;
+    };
+
     void InitRenderData();
     int FirstUnusedParticleIndex();
-    void RespawnParticles(int index, GameObject* object, const QVector2D& offset);
+    void RespawnParticles(int index, const QVector2D& pos, const QVector2D& velocity);
+
+    int StreamCpuParticles();
+
+    bool InitGpuData();
+    void UploadGpuState();
+    void SimulateOnGpu();
 
 private:
     std::vector<Particel> particles_;
     int lastUnusedIndex_;
+    float settle_time_;
+
+    std::vector<ParticleInstance> instances_;
 
     quint32 vao_;
+    quint32 quad_vbo_;
+    quint32 instance_vbo_;
     std::shared_ptr<QOpenGLShaderProgram> shader_;
-    std::shared_ptr<QOpenGLTexture> texture_;
+    int tex_rect_location_;
+    TextureRegion sprite_;
+
+    bool is_gpu_simulation_;
+    bool is_gpu_active_;
+    std::vector<EmitterStep> pending_steps_;
+    int spawn_begin_;
+    int current_state_;
+
+    quint32 state_vbo_[2];
+    quint32 update_vao_[2];
+    quint32 render_vao_[2];
+    std::unique_ptr<QOpenGLShaderProgram> update_shader_;
+    UpdateLocations update_locations_;
+
+    std::shared_ptr<GlStateCache> gl_state_;
 };
 
+inline bool ParticleGenerator::IsGpuSimulation()
+{
+    return is_gpu_simulation_;
+}
+
+inline bool ParticleGenerator::IsIdle()
+{
+    return settle_time_ <= 0.0f;
+}
+
 #endif
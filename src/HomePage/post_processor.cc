@@ -1,8 +1,9 @@
 #include "post_processor.h"
 
-#include <QDateTime>
 #include <QOpenGLVertexArrayObject>
 
+#include "shader_cache.h"
+
 // clang-format off
 static constexpr float vertices[] = {
 	// vertext   // texture pos	
@@ -42,23 +43,27 @@ static constexpr GLfloat  edge_kernels[9] {
 // clang-format on
 
 
-PostProcessor::PostProcessor(std::shared_ptr<QOpenGLShaderProgram> shader,
-                             std::shared_ptr<QOpenGLFramebufferObject> fbo)
+// The defines have to follow the #version line.
+static QByteArray InsertDefines(const QByteArray& source, const QByteArray& defines)
+{
+    int line_end = source.indexOf('\n') + 1;
+    return source.left(line_end) + defines + source.mid(line_end);
+}
 
+PostProcessor::PostProcessor(std::shared_ptr<QOpenGLFramebufferObject> fbo,
+                             FrameUniforms& frame_uniforms)
     : vao_(0)
-    , shader_(shader)
     , fbo_(fbo)
     , is_shake_(false)
     , is_confuse_(false)
     , is_chaos_(false)
+    , is_bypassed_(true)
     , duration_(0)
+    , gl_state_(Singleton<GlStateCache>::Instance())
 {
     InitRenderData();
-
-    shader_->bind();
-    shader_->setUniformValueArray("offsets", (float*)offsets, 9, 2);
-    shader_->setUniformValueArray("blur_kernels", blur_kernels, 9, 1);
-    shader_->setUniformValueArray("edge_kernels", edge_kernels, 9, 1);
+    InitFboTexture();
+    InitVariants(frame_uniforms);
 }
 
 PostProcessor::~PostProcessor()
@@ -68,24 +73,24 @@ PostProcessor::~PostProcessor()
 
 void PostProcessor::BeginProcessor()
 {
+    // Effects toggled during the frame take effect on the next one.
+    is_bypassed_ = EffectMask() == 0;
+    if (is_bypassed_)
+        return;
+
     fbo_->bind();
 }
 
-void PostProcessor::EndProcessor()
+void PostProcessor::EndProcessor(GLuint target_fbo)
 {
-    auto ct = QOpenGLContext::currentContext();
-    if (!ct)
+    if (is_bypassed_)
         return;
 
-    glBindFramebuffer(GL_FRAMEBUFFER, ct->defaultFramebufferObject());
+    glBindFramebuffer(GL_FRAMEBUFFER, target_fbo);
 }
 
 void PostProcessor::Update(float dt)
 {
-    shader_->bind();
-    shader_->setUniformValue("time",
-                             static_cast<int>(QDateTime::currentDateTime().toMSecsSinceEpoch()));
-
     if (duration_ > 0.0f) {
         duration_ = std::max(duration_ - dt, 0.0f);
     }
@@ -97,37 +102,22 @@ void PostProcessor::Update(float dt)
 
 void PostProcessor::Draw()
 {
-    shader_->bind();
-    shader_->setUniformValue("image", 0);
-    shader_->setUniformValue("is_shake", is_shake_);
-    shader_->setUniformValue("is_confuse", is_confuse_);
-    shader_->setUniformValue("is_chaos", is_chaos_);
-
-    QMatrix4x4 proj_mat;
-    proj_mat.ortho(0.0f, fbo_->size().width(), fbo_->size().height(), 0.0f, -1.0f, 1.0f);
-    shader_->setUniformValue("proj_mat", proj_mat);
-
-    QMatrix4x4 model_mat;
-    model_mat.translate(QVector2D(0.0f, 0.0f));
-    model_mat.scale(QVector2D(fbo_->size().width(), fbo_->size().height()));
-    shader_->setUniformValue("model_mat", model_mat);
-
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, fbo_->texture());
-    // repeat wrap mode
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    if (is_bypassed_)
+        return;
 
-    glBindVertexArray(vao_);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
+    // The quad is scaled to the screen by the Frame block, the fbo has the same size.
+    gl_state_->UseProgram(variants_[EffectMask()]->programId());
+
+    gl_state_->BindTexture(fbo_->texture());
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    gl_state_->BindVertexArray(vao_);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
 }
 
 void PostProcessor::SetFbo(std::shared_ptr<QOpenGLFramebufferObject> fbo)
 {
     fbo_ = fbo;
+    InitFboTexture();
 }
 
 void PostProcessor::SetShake(bool state)
@@ -151,7 +141,7 @@ void PostProcessor::InitRenderData()
     initializeOpenGLFunctions();
 
     glGenVertexArrays(1, &vao_);
-    glBindVertexArray(vao_);
+    gl_state_->BindVertexArray(vao_);
 
     quint32 vbo;
     glGenBuffers(1, &vbo);
@@ -162,6 +152,65 @@ void PostProcessor::InitRenderData()
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(float) * 4, nullptr);
 
-    glBindVertexArray(0);
+    gl_state_->BindVertexArray(0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
+
+void PostProcessor::InitFboTexture()
+{
+    // repeat wrap mode, set once per fbo
+    gl_state_->BindTexture(fbo_->texture());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+}
+
+void PostProcessor::InitVariants(FrameUniforms& frame_uniforms)
+{
+    auto shader_cache = Singleton<ShaderCache>::Instance();
+    QByteArray vertex_source = ShaderCache::ReadSource(":/res/shaders/post_processor.vert");
+    QByteArray fragment_source = ShaderCache::ReadSource(":/res/shaders/post_processor.frag");
+
+    for (int mask = 0; mask < EF_VARIANT_COUNT; ++mask) {
+        QByteArray defines;
+        if (mask & EF_SHAKE) {
+            defines += "#define SHAKE\n";
+        }
+        if (mask & EF_CONFUSE) {
+            defines += "#define CONFUSE\n";
+        }
+        if (mask & EF_CHAOS) {
+            defines += "#define CHAOS\n";
+        }
+
+        auto program = std::make_unique<QOpenGLShaderProgram>();
+        shader_cache->Build(program.get(), "post_processor_" + std::to_string(mask),
+                            {{QOpenGLShader::Vertex, InsertDefines(vertex_source, defines)},
+                             {QOpenGLShader::Fragment, InsertDefines(fragment_source, defines)}});
+        frame_uniforms.Attach(program->programId());
+
+        // unused arrays are optimized out per variant, their locations are simply -1
+        gl_state_->UseProgram(program->programId());
+        program->setUniformValue("scene", 0);
+        program->setUniformValueArray("offsets", (float*)offsets, 9, 2);
+        program->setUniformValueArray("blur_kernels", blur_kernels, 9, 1);
+        program->setUniformValueArray("edge_kernels", edge_kernels, 9, 1);
+
+        variants_[mask] = std::move(program);
+    }
+}
+
+int PostProcessor::EffectMask()
+{
+    int mask = 0;
+    if (is_shake_) {
+        mask |= EF_SHAKE;
+    }
+    if (is_confuse_) {
+        mask |= EF_CONFUSE;
+    }
+    if (is_chaos_) {
+        mask |= EF_CHAOS;
+    }
+
+    return mask;
+}
@@ -5,17 +5,28 @@
 #include <QOpenGLFunctions_3_3_Core>
 #include <QOpenGLShaderProgram>
 #include <QVector2D>
-#include <vector>
 
+#include "frame_uniforms.h"
+#include "gl_state_cache.h"
+
+/**
+ * @brief Full-screen effects. While no effect is on, the frame is drawn straight to the default
+ * framebuffer; the choice is made once per frame in BeginProcessor().
+ *
+ * Every effect combination is compiled up front as its own program variant, so the shaders do
+ * not branch on the effect state.
+ */
 class PostProcessor : protected QOpenGLFunctions_3_3_Core
 {
 public:
-    PostProcessor(std::shared_ptr<QOpenGLShaderProgram> shader,
-                  std::shared_ptr<QOpenGLFramebufferObject> fbo);
+    PostProcessor(std::shared_ptr<QOpenGLFramebufferObject> fbo, FrameUniforms& frame_uniforms);
     ~PostProcessor();
 
     void BeginProcessor();
-    void EndProcessor();
+    /**
+     * @param target_fbo Framebuffer that receives the processed frame in Draw().
+     */
+    void EndProcessor(GLuint target_fbo);
     void Update(float dt);
     void Draw();
 
@@ -24,19 +35,51 @@ public:
     void SetConfuse(bool state);
     void SetChaos(bool state);
 
+    /**
+     * @brief No effect is on this frame, set in BeginProcessor().
+     */
+    inline bool IsBypassed();
+
+    /**
+     * @brief Shake and chaos move with time, the frame changes even when the scene does not.
+     */
+    inline bool IsAnimated();
+
 private:
+    enum EffectFlag
+    {
+        EF_SHAKE = 0x1,
+        EF_CONFUSE = 0x2,
+        EF_CHAOS = 0x4,
+        EF_VARIANT_COUNT = 0x8
+    };
+
     void InitRenderData();
+    void InitFboTexture();
+    void InitVariants(FrameUniforms& frame_uniforms);
+    int EffectMask();
 
 private:
     quint32 vao_;
-    QSize size_;
     bool is_shake_;
     bool is_confuse_;
     bool is_chaos_;
-    std::shared_ptr<QOpenGLShaderProgram> shader_;
+    bool is_bypassed_;
+    std::unique_ptr<QOpenGLShaderProgram> variants_[EF_VARIANT_COUNT];
     std::shared_ptr<QOpenGLFramebufferObject> fbo_;
 
     float duration_;
+    std::shared_ptr<GlStateCache> gl_state_;
 };
 
+inline bool PostProcessor::IsBypassed()
+{
+    return is_bypassed_;
+}
+
+inline bool PostProcessor::IsAnimated()
+{
+    return is_shake_ || is_chaos_;
+}
+
 #endif
@@ -0,0 +1,141 @@
+#include "sprite_batch.h"
+
+// clang-format off
+static float sprite_vertices[] = {
+	// vertext   // texture pos
+	0.0f, 1.0f, 0.0f, 1.0f,
+	1.0f, 1.0f, 1.0f, 1.0f,
+	0.0f, 0.0f, 0.0f, 0.0f,
+
+	1.0f, 0.0f, 1.0f, 0.0f,
+	0.0f, 0.0f, 0.0f, 0.0f,
+	1.0f, 1.0f, 1.0f, 1.0f,
+};
+// clang-format on
+
+SpriteBatch::SpriteBatch(std::shared_ptr<QOpenGLShaderProgram>& shader_program, int capacity)
+    : vao_(0)
+    , quad_vbo_(0)
+    , instance_vbo_(0)
+    , shader_program_(shader_program)
+    , capacity_(capacity)
+    , texture_(0)
+    , draw_calls_(0)
+    , gl_state_(Singleton<GlStateCache>::Instance())
+{
+    instances_.reserve(capacity_);
+
+    InitRenderData();
+
+    // The projection comes from the shared Frame block, only the sampler is set here.
+    gl_state_->UseProgram(shader_program_->programId());
+    shader_program_->setUniformValue("image", 0);
+}
+
+SpriteBatch::~SpriteBatch()
+{
+    shader_program_->release();
+    glDeleteVertexArrays(1, &vao_);
+    glDeleteBuffers(1, &quad_vbo_);
+    glDeleteBuffers(1, &instance_vbo_);
+}
+
+void SpriteBatch::Begin()
+{
+    instances_.clear();
+    texture_ = 0;
+    draw_calls_ = 0;
+}
+
+void SpriteBatch::End()
+{
+    Flush();
+}
+
+void SpriteBatch::Flush()
+{
+    if (instances_.empty())
+        return;
+
+    gl_state_->UseProgram(shader_program_->programId());
+    gl_state_->SetBlend(true);
+    gl_state_->BlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); // premultiplied textures
+
+    gl_state_->BindTexture(texture_);
+
+    gl_state_->BindVertexArray(vao_);
+
+    // Orphan the buffer so the driver does not stall on the previous batch.
+    GLsizeiptr bytes = sizeof(SpriteInstance) * instances_.size();
+    glBindBuffer(GL_ARRAY_BUFFER, instance_vbo_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(SpriteInstance) * capacity_, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, instances_.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, (GLsizei)instances_.size());
+    ++draw_calls_;
+
+    instances_.clear();
+}
+
+void SpriteBatch::Draw(std::shared_ptr<QOpenGLTexture> texture, const QVector2D& pos,
+                       const QVector2D& size, float rotate, const QVector3D& color,
+                       const QVector4D& tex_rect)
+{
+    GLuint tex_id = 0;
+    if (texture && texture->isCreated()) {
+        tex_id = texture->textureId();
+    }
+
+    Draw(tex_id, pos, size, rotate, color, tex_rect);
+}
+
+void SpriteBatch::Draw(const TextureRegion& sprite, const QVector2D& pos, const QVector2D& size,
+                       float rotate, const QVector3D& color)
+{
+    Draw(sprite.texture, pos, size, rotate, color, sprite.tex_rect);
+}
+
+void SpriteBatch::Draw(GLuint texture, const QVector2D& pos, const QVector2D& size, float rotate,
+                       const QVector3D& color, const QVector4D& tex_rect)
+{
+    if (texture != texture_ || (int)instances_.size() >= capacity_) {
+        Flush();
+        texture_ = texture;
+    }
+
+    SpriteInstance instance = {{pos.x(), pos.y(), size.x(), size.y()},
+                               {color.x(), color.y(), color.z(), rotate},
+                               {tex_rect.x(), tex_rect.y(), tex_rect.z(), tex_rect.w()}};
+    instances_.emplace_back(instance);
+}
+
+void SpriteBatch::InitRenderData()
+{
+    initializeOpenGLFunctions();
+
+    glGenVertexArrays(1, &vao_);
+    gl_state_->BindVertexArray(vao_);
+
+    glGenBuffers(1, &quad_vbo_);
+    glBindBuffer(GL_ARRAY_BUFFER, quad_vbo_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(sprite_vertices), sprite_vertices, GL_STATIC_DRAW);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(float) * 4, nullptr);
+
+    // per-instance attributes
+    glGenBuffers(1, &instance_vbo_);
+    glBindBuffer(GL_ARRAY_BUFFER, instance_vbo_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(SpriteInstance) * capacity_, nullptr, GL_STREAM_DRAW);
+
+    for (GLuint i = 0; i < 3; ++i) {
+        glEnableVertexAttribArray(1 + i);
+        glVertexAttribPointer(1 + i, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+                              (void*)(sizeof(float) * 4 * i));
+        glVertexAttribDivisor(1 + i, 1);
+    }
+
+    gl_state_->BindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,74 @@
+#ifndef SPRITE_BATCH_H_
+#define SPRITE_BATCH_H_
+
+#include <QOpenGLFunctions_3_3_Core>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLTexture>
+#include <memory>
+#include <vector>
+
+#include "gl_state_cache.h"
+#include "texture_atlas.h"
+
+/**
+ * @brief Batched sprite renderer. Sprites are queued as instances and drawn with one
+ * instanced call per texture change, or when Flush() is called before another shader is used.
+ */
+class SpriteBatch : protected QOpenGLFunctions_3_3_Core
+{
+public:
+    SpriteBatch(std::shared_ptr<QOpenGLShaderProgram>& shader_program, int capacity = 4096);
+    ~SpriteBatch();
+
+    void Begin();
+    void End();
+    void Flush();
+
+    /**
+     * @param tex_rect Texture coordinates of the sprite, (u0, v0, u1, v1).
+     */
+    void Draw(std::shared_ptr<QOpenGLTexture> texture, const QVector2D& pos,
+              const QVector2D& size = QVector2D(10.0f, 10.0f), float rotate = 0.0f,
+              const QVector3D& color = QVector3D(1.0f, 1.0f, 1.0f),
+              const QVector4D& tex_rect = QVector4D(0.0f, 0.0f, 1.0f, 1.0f));
+
+    void Draw(const TextureRegion& sprite, const QVector2D& pos,
+              const QVector2D& size = QVector2D(10.0f, 10.0f), float rotate = 0.0f,
+              const QVector3D& color = QVector3D(1.0f, 1.0f, 1.0f));
+
+    void Draw(GLuint texture, const QVector2D& pos, const QVector2D& size = QVector2D(10.0f, 10.0f),
+              float rotate = 0.0f, const QVector3D& color = QVector3D(1.0f, 1.0f, 1.0f),
+              const QVector4D& tex_rect = QVector4D(0.0f, 0.0f, 1.0f, 1.0f));
+
+    inline int DrawCalls();
+
+private:
+    struct SpriteInstance
+    {
+        float rect[4];     // pos.xy, size.xy
+        float color[4];    // rgb, rotate
+        float tex_rect[4]; // u0, v0, u1, v1
+    };
+
+    void InitRenderData();
+
+private:
+    quint32 vao_;
+    quint32 quad_vbo_;
+    quint32 instance_vbo_;
+    std::shared_ptr<QOpenGLShaderProgram> shader_program_;
+
+    int capacity_;
+    GLuint texture_;
+    std::vector<SpriteInstance> instances_;
+
+    int draw_calls_;
+    std::shared_ptr<GlStateCache> gl_state_;
+};
+
+inline int SpriteBatch::DrawCalls()
+{
+    return draw_calls_;
+}
+
+#endif
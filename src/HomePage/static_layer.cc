@@ -0,0 +1,46 @@
+#include "static_layer.h"
+
+// never matches a level revision, forces a redraw
+static const int kInvalidRevision = -1;
+
+StaticLayer::StaticLayer()
+    : revision_(kInvalidRevision)
+{
+    initializeOpenGLFunctions();
+}
+
+void StaticLayer::Resize(int w, int h)
+{
+    if (fbo_ && fbo_->size() == QSize(w, h))
+        return;
+
+    fbo_ = std::make_unique<QOpenGLFramebufferObject>(w, h);
+    revision_ = kInvalidRevision;
+}
+
+void StaticLayer::Begin()
+{
+    fbo_->bind();
+
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    // Keep the layer opaque, so compositing it with blending on shows nothing behind it.
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_FALSE);
+}
+
+void StaticLayer::End(int revision, GLuint target_fbo)
+{
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glBindFramebuffer(GL_FRAMEBUFFER, target_fbo);
+
+    revision_ = revision;
+}
+
+void StaticLayer::Draw(std::shared_ptr<SpriteBatch> batch)
+{
+    // The fbo texture is stored bottom-up, flip v for the y-down sprite projection.
+    batch->Draw(fbo_->texture(), QVector2D(0.0f, 0.0f),
+                QVector2D(fbo_->width(), fbo_->height()), 0.0f, QVector3D(1.0f, 1.0f, 1.0f),
+                QVector4D(0.0f, 1.0f, 1.0f, 0.0f));
+}
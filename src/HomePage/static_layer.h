@@ -0,0 +1,43 @@
+#ifndef STATIC_LAYER_H_
+#define STATIC_LAYER_H_
+
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions_3_3_Core>
+#include <memory>
+
+#include "sprite_batch.h"
+
+/**
+ * @brief Offscreen copy of the parts of the scene that rarely change, the background and the
+ * brick field. It is redrawn only when the level revision or the size changes, every other
+ * frame composites it with a single sprite.
+ */
+class StaticLayer : protected QOpenGLFunctions_3_3_Core
+{
+public:
+    StaticLayer();
+    ~StaticLayer() = default;
+
+    void Resize(int w, int h);
+
+    inline bool IsStale(int revision);
+
+    /**
+     * @brief Redirect drawing into the layer. Everything drawn until End() replaces its content.
+     */
+    void Begin();
+    void End(int revision, GLuint target_fbo);
+
+    void Draw(std::shared_ptr<SpriteBatch> batch);
+
+private:
+    std::unique_ptr<QOpenGLFramebufferObject> fbo_;
+    int revision_;
+};
+
+inline bool StaticLayer::IsStale(int revision)
+{
+    return !fbo_ || revision != revision_;
+}
+
+#endif
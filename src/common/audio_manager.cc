@@ -1,6 +1,7 @@
 #include "audio_manager.h"
 
 AudioManager::AudioManager()
+    : is_muted_(false)
 {
     sound_effect_ = std::make_unique<QSoundEffect>();
     sound_effect_->setVolume(0.25f);
@@ -8,6 +9,9 @@ AudioManager::AudioManager()
 
 void AudioManager::Play(const char* file, int loop_count)
 {
+    if (is_muted_)
+        return;
+
     sound_effect_->setLoopCount(loop_count);
     sound_effect_->setSource(QUrl::fromLocalFile(file));
     sound_effect_->play();
@@ -17,3 +21,11 @@ void AudioManager::Stop()
 {
     sound_effect_->stop();
 }
+
+void AudioManager::SetMuted(bool muted)
+{
+    is_muted_ = muted;
+    if (is_muted_) {
+        sound_effect_->stop();
+    }
+}
@@ -15,8 +15,14 @@ public:
     void Play(const char* file, int loop_count = QSoundEffect::Infinite);
     void Stop();
 
+    /**
+     * @brief Muted, Play() does nothing. Used when running headless.
+     */
+    void SetMuted(bool muted);
+
 private:
     std::unique_ptr<QSoundEffect> sound_effect_;
+    bool is_muted_;
 };
 
 #endif
@@ -0,0 +1,279 @@
+#include "cooked_texture.h"
+
+#include <QOpenGLPixelTransferOptions>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+static const char kMagic[4] = {'C', 'T', 'E', 'X'};
+
+// 2x2 box filter, the last row or column is reused on odd sizes.
+static std::vector<uchar> Downsample(const std::vector<uchar>& src, int w, int h, int channels,
+                                     int dst_w, int dst_h)
+{
+    std::vector<uchar> dst((size_t)dst_w * dst_h * channels);
+    for (int y = 0; y < dst_h; ++y) {
+        int y0 = std::min(y * 2, h - 1);
+        int y1 = std::min(y * 2 + 1, h - 1);
+        for (int x = 0; x < dst_w; ++x) {
+            int x0 = std::min(x * 2, w - 1);
+            int x1 = std::min(x * 2 + 1, w - 1);
+            for (int c = 0; c < channels; ++c) {
+                int sum = src[((size_t)y0 * w + x0) * channels + c] +
+                          src[((size_t)y0 * w + x1) * channels + c] +
+                          src[((size_t)y1 * w + x0) * channels + c] +
+                          src[((size_t)y1 * w + x1) * channels + c];
+                dst[((size_t)y * dst_w + x) * channels + c] = (uchar)((sum + 2) / 4);
+            }
+        }
+    }
+
+    return dst;
+}
+
+CookedTexture::CookedTexture()
+    : data_(nullptr)
+    , size_(0)
+{}
+
+CookedTexture::~CookedTexture()
+{
+    if (file_.isOpen()) {
+        file_.close();
+    }
+}
+
+QByteArray CookedTexture::Cook(const QImage& image, int max_mip_level,
+                               const std::vector<AtlasSprite>& sprites)
+{
+    // nothing to cook, and the mip chain below needs at least one pixel
+    if (image.isNull() || image.width() <= 0 || image.height() <= 0)
+        return QByteArray();
+
+    QImage base = image.convertToFormat(QImage::Format_RGBA8888_Premultiplied);
+    int w = base.width();
+    int h = base.height();
+
+    // Gray images only need one channel, the swizzle restores the others.
+    bool is_gray = true;
+    bool is_alpha = true;
+    bool is_opaque = true;
+    for (int y = 0; y < h && is_gray; ++y) {
+        const uchar* pixel = base.constScanLine(y);
+        for (int x = 0; x < w; ++x, pixel += 4) {
+            if (pixel[0] != pixel[1] || pixel[0] != pixel[2]) {
+                is_gray = false;
+                break;
+            }
+            is_alpha = is_alpha && pixel[0] == pixel[3];
+            is_opaque = is_opaque && pixel[3] == 255;
+        }
+    }
+
+    Format format = CF_RGBA8;
+    if (is_gray && is_opaque) {
+        format = CF_R8_OPAQUE;
+    } else if (is_gray && is_alpha) {
+        format = CF_R8_ALPHA;
+    }
+    int channels = Channels(format);
+
+    std::vector<std::vector<uchar>> levels(1);
+    levels[0].resize((size_t)w * h * channels);
+    for (int y = 0; y < h; ++y) {
+        const uchar* pixel = base.constScanLine(y);
+        uchar* row = levels[0].data() + (size_t)y * w * channels;
+        if (channels == 4) {
+            memcpy(row, pixel, (size_t)w * 4);
+        } else {
+            for (int x = 0; x < w; ++x) {
+                row[x] = pixel[x * 4];
+            }
+        }
+    }
+
+    std::vector<QSize> sizes(1, QSize(w, h));
+    while ((int)levels.size() <= max_mip_level && sizes.back() != QSize(1, 1)) {
+        QSize size = sizes.back();
+        QSize next(std::max(size.width() / 2, 1), std::max(size.height() / 2, 1));
+        levels.emplace_back(Downsample(levels.back(), size.width(), size.height(), channels,
+                                       next.width(), next.height()));
+        sizes.emplace_back(next);
+    }
+
+    CtexHeader header;
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.format = format;
+    header.width = w;
+    header.height = h;
+    header.levels = (quint32)levels.size();
+    header.sprite_count = (quint32)sprites.size();
+    header.reserved = 0;
+
+    quint32 offset = sizeof(CtexHeader) + sizeof(CtexLevel) * header.levels +
+                     sizeof(CtexSprite) * header.sprite_count;
+
+    QByteArray blob;
+    blob.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (size_t i = 0; i < levels.size(); ++i) {
+        CtexLevel level = {(quint32)sizes[i].width(), (quint32)sizes[i].height(), offset,
+                           (quint32)levels[i].size()};
+        blob.append(reinterpret_cast<const char*>(&level), sizeof(level));
+        offset += level.size;
+    }
+
+    for (auto& sprite : sprites) {
+        CtexSprite entry;
+        memset(&entry, 0, sizeof(entry));
+        strncpy(entry.name, sprite.name.c_str(), kMaxNameLength - 1);
+        entry.x = sprite.rect.x();
+        entry.y = sprite.rect.y();
+        entry.w = sprite.rect.width();
+        entry.h = sprite.rect.height();
+        blob.append(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    }
+
+    for (auto& level : levels) {
+        blob.append(reinterpret_cast<const char*>(level.data()), (int)level.size());
+    }
+
+    return blob;
+}
+
+bool CookedTexture::Open(const QString& file)
+{
+    file_.setFileName(file);
+    if (!file_.open(QIODevice::ReadOnly))
+        return false;
+
+    size_ = file_.size();
+    data_ = file_.map(0, size_);
+    if (!data_) {
+        std::cout << "Map cooked texture fail. path: " << file.toStdString() << std::endl;
+        return false;
+    }
+
+    return Validate();
+}
+
+bool CookedTexture::Load(const QByteArray& blob)
+{
+    blob_ = blob;
+    data_ = reinterpret_cast<const uchar*>(blob_.constData());
+    size_ = blob_.size();
+
+    return Validate();
+}
+
+std::shared_ptr<QOpenGLTexture> CookedTexture::Upload()
+{
+    if (!data_)
+        return nullptr;
+
+    auto header = Header();
+    bool is_r8 = header->format != CF_RGBA8;
+    auto pixel_format = is_r8 ? QOpenGLTexture::Red : QOpenGLTexture::RGBA;
+
+    auto texture = std::make_shared<QOpenGLTexture>(QOpenGLTexture::Target2D);
+    texture->setSize(header->width, header->height);
+    texture->setFormat(is_r8 ? QOpenGLTexture::R8_UNorm : QOpenGLTexture::RGBA8_UNorm);
+    texture->setMipLevels(header->levels);
+    texture->allocateStorage(pixel_format, QOpenGLTexture::UInt8);
+
+    // Rows are tightly packed, single channel levels are not 4-byte aligned.
+    QOpenGLPixelTransferOptions options;
+    options.setAlignment(1);
+    for (quint32 level = 0; level < header->levels; ++level) {
+        texture->setData(level, pixel_format, QOpenGLTexture::UInt8,
+                         data_ + Levels()[level].offset, &options);
+    }
+
+    if (header->format == CF_R8_ALPHA) {
+        texture->setSwizzleMask(QOpenGLTexture::RedValue, QOpenGLTexture::RedValue,
+                                QOpenGLTexture::RedValue, QOpenGLTexture::RedValue);
+    } else if (header->format == CF_R8_OPAQUE) {
+        texture->setSwizzleMask(QOpenGLTexture::RedValue, QOpenGLTexture::RedValue,
+                                QOpenGLTexture::RedValue, QOpenGLTexture::OneValue);
+    }
+
+    texture->setMipMaxLevel(header->levels - 1);
+    texture->setMinificationFilter(header->levels > 1 ? QOpenGLTexture::LinearMipMapLinear
+                                                      : QOpenGLTexture::Linear);
+    texture->setMagnificationFilter(QOpenGLTexture::Linear);
+    texture->setWrapMode(QOpenGLTexture::ClampToEdge);
+
+    return texture;
+}
+
+std::vector<AtlasSprite> CookedTexture::Sprites(int page)
+{
+    std::vector<AtlasSprite> sprites;
+    if (!data_)
+        return sprites;
+
+    for (quint32 i = 0; i < Header()->sprite_count; ++i) {
+        const CtexSprite& entry = SpriteTable()[i];
+        std::string name(entry.name, strnlen(entry.name, kMaxNameLength));
+        sprites.push_back({name, page, QRect(entry.x, entry.y, entry.w, entry.h)});
+    }
+
+    return sprites;
+}
+
+bool CookedTexture::Validate()
+{
+    bool is_valid = size_ >= (qint64)sizeof(CtexHeader) &&
+                    memcmp(Header()->magic, kMagic, sizeof(kMagic)) == 0 &&
+                    Header()->version == kVersion && Channels(Header()->format) > 0 &&
+                    Header()->width > 0 && Header()->height > 0 && Header()->levels > 0;
+
+    // no more levels than halving the larger side down to one pixel gives
+    if (is_valid) {
+        quint32 mip_count = 1;
+        for (quint32 side = std::max(Header()->width, Header()->height); side > 1; side /= 2) {
+            ++mip_count;
+        }
+        is_valid = Header()->levels <= mip_count;
+    }
+
+    qint64 table_end = sizeof(CtexHeader);
+    if (is_valid) {
+        table_end += sizeof(CtexLevel) * (qint64)Header()->levels +
+                     sizeof(CtexSprite) * (qint64)Header()->sprite_count;
+        is_valid = table_end <= size_;
+    }
+
+    // Upload() reads whole levels, each must have the size its place in the chain gives.
+    int channels = is_valid ? Channels(Header()->format) : 0;
+    for (quint32 level = 0; is_valid && level < Header()->levels; ++level) {
+        const CtexLevel& entry = Levels()[level];
+        quint32 w = std::max(Header()->width >> level, 1u);
+        quint32 h = std::max(Header()->height >> level, 1u);
+        is_valid = entry.width == w && entry.height == h &&
+                   entry.size == (qint64)w * h * channels &&
+                   (qint64)entry.offset + entry.size <= size_;
+    }
+
+    if (!is_valid) {
+        std::cout << "Cooked texture is invalid. path: " << file_.fileName().toStdString()
+                  << std::endl;
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    return is_valid;
+}
+
+int CookedTexture::Channels(quint32 format)
+{
+    switch (format) {
+    case CF_RGBA8:
+        return 4;
+    case CF_R8_ALPHA:
+    case CF_R8_OPAQUE:
+        return 1;
+    default:
+        return 0;
+    }
+}
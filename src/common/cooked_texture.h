@@ -0,0 +1,125 @@
+#ifndef COOKED_TEXTURE_H_
+#define COOKED_TEXTURE_H_
+
+#include <QByteArray>
+#include <QFile>
+#include <QImage>
+#include <QOpenGLTexture>
+#include <memory>
+#include <vector>
+
+#include "texture_atlas.h"
+
+/**
+ * @brief GPU-ready texture blob (.ctex), written offline by asset_cooker. The pixels are
+ * premultiplied, already in the upload format and carry their whole mip chain, so loading is a
+ * memory map and one upload per level. Atlas pages also carry their sprite table.
+ *
+ * Layout: CtexHeader, CtexLevel[levels], CtexSprite[sprite_count], pixel data. Offsets are from
+ * the start of the blob. Fields are in host byte order, the blobs are cooked by the build for the
+ * machine that runs the game.
+ */
+class CookedTexture
+{
+public:
+    enum Format
+    {
+        CF_RGBA8,
+        CF_R8_ALPHA, // white sprite, premultiplied luminance equals alpha, sampled as rrrr
+        CF_R8_OPAQUE // opaque gray image, sampled as rrr1
+    };
+
+    CookedTexture();
+    ~CookedTexture();
+
+    /**
+     * @brief Premultiply the image, pick the smallest format and build up to max_mip_level
+     * mip levels below the base image.
+     * @return Empty for a null or empty image.
+     */
+    static QByteArray Cook(const QImage& image, int max_mip_level,
+                           const std::vector<AtlasSprite>& sprites = std::vector<AtlasSprite>());
+
+    /**
+     * @brief Map a blob file. The mapping is kept until the object is destroyed.
+     */
+    bool Open(const QString& file);
+
+    /**
+     * @brief Use a blob cooked in memory, for images that were not cooked offline.
+     */
+    bool Load(const QByteArray& blob);
+
+    /**
+     * @brief Requires a current GL context.
+     */
+    std::shared_ptr<QOpenGLTexture> Upload();
+
+    /**
+     * @param page Page index stored in the returned sprites.
+     */
+    std::vector<AtlasSprite> Sprites(int page);
+
+private:
+    static constexpr quint32 kVersion = 1;
+    static constexpr int kMaxNameLength = 32;
+
+    struct CtexHeader
+    {
+        char magic[4];
+        quint32 version;
+        quint32 format;
+        quint32 width;
+        quint32 height;
+        quint32 levels;
+        quint32 sprite_count;
+        quint32 reserved;
+    };
+
+    struct CtexLevel
+    {
+        quint32 width;
+        quint32 height;
+        quint32 offset;
+        quint32 size;
+    };
+
+    struct CtexSprite
+    {
+        char name[kMaxNameLength];
+        quint32 x;
+        quint32 y;
+        quint32 w;
+        quint32 h;
+    };
+
+    bool Validate();
+    static int Channels(quint32 format);
+
+    inline const CtexHeader* Header();
+    inline const CtexLevel* Levels();
+    inline const CtexSprite* SpriteTable();
+
+private:
+    QFile file_;
+    QByteArray blob_;
+    const uchar* data_;
+    qint64 size_;
+};
+
+inline const CookedTexture::CtexHeader* CookedTexture::Header()
+{
+    return reinterpret_cast<const CtexHeader*>(data_);
+}
+
+inline const CookedTexture::CtexLevel* CookedTexture::Levels()
+{
+    return reinterpret_cast<const CtexLevel*>(data_ + sizeof(CtexHeader));
+}
+
+inline const CookedTexture::CtexSprite* CookedTexture::SpriteTable()
+{
+    return reinterpret_cast<const CtexSprite*>(Levels() + Header()->levels);
+}
+
+#endif
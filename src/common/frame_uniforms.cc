@@ -0,0 +1,52 @@
+#include "frame_uniforms.h"
+
+#include <QMatrix4x4>
+#include <algorithm>
+#include <cstddef>
+
+FrameUniforms::FrameUniforms()
+    : block_()
+    , ubo_(0)
+{
+    initializeOpenGLFunctions();
+
+    glGenBuffers(1, &ubo_);
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameBlock), &block_, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    glBindBufferBase(GL_UNIFORM_BUFFER, kBindingPoint, ubo_);
+}
+
+FrameUniforms::~FrameUniforms()
+{
+    glDeleteBuffers(1, &ubo_);
+}
+
+void FrameUniforms::Attach(GLuint program)
+{
+    GLuint index = glGetUniformBlockIndex(program, "Frame");
+    if (index != GL_INVALID_INDEX) {
+        glUniformBlockBinding(program, index, kBindingPoint);
+    }
+}
+
+void FrameUniforms::SetScreenSize(int w, int h)
+{
+    QMatrix4x4 proj_mat;
+    proj_mat.ortho(0.0f, (float)w, (float)h, 0.0f, -1.0f, 1.0f);
+    std::copy(proj_mat.constData(), proj_mat.constData() + 16, block_.proj_mat);
+    block_.screen_size[0] = (float)w;
+    block_.screen_size[1] = (float)h;
+
+    glBindBufferBase(GL_UNIFORM_BUFFER, kBindingPoint, ubo_);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameBlock), &block_);
+}
+
+void FrameUniforms::SetTime(float time)
+{
+    block_.time = time;
+
+    glBindBufferBase(GL_UNIFORM_BUFFER, kBindingPoint, ubo_);
+    glBufferSubData(GL_UNIFORM_BUFFER, offsetof(FrameBlock, time), sizeof(float), &block_.time);
+}
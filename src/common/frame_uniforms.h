@@ -0,0 +1,43 @@
+#ifndef FRAME_UNIFORMS_H_
+#define FRAME_UNIFORMS_H_
+
+#include <QOpenGLExtraFunctions>
+
+/**
+ * @brief Per-frame values shared by all programs through one uniform buffer. Shaders declare
+ *
+ *     layout (std140) uniform Frame { mat4 proj_mat; vec2 screen_size; float time; };
+ *
+ * and each program is attached to the binding point once after linking.
+ */
+class FrameUniforms : protected QOpenGLExtraFunctions
+{
+public:
+    static constexpr GLuint kBindingPoint = 0;
+
+    FrameUniforms();
+    ~FrameUniforms();
+
+    void Attach(GLuint program);
+
+    /**
+     * @brief Rebuilds the y-down orthographic projection, call from resizeGL.
+     */
+    void SetScreenSize(int w, int h);
+    void SetTime(float time);
+
+private:
+    // std140 layout of the Frame block
+    struct FrameBlock
+    {
+        float proj_mat[16];
+        float screen_size[2];
+        float time;
+        float padding;
+    };
+
+    FrameBlock block_;
+    GLuint ubo_;
+};
+
+#endif
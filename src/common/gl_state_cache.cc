@@ -0,0 +1,98 @@
+#include "gl_state_cache.h"
+
+GlStateCache::GlStateCache()
+{
+    initializeOpenGLFunctions();
+    Invalidate();
+}
+
+void GlStateCache::BeginFrame()
+{
+    last_stats_ = stats_;
+    stats_ = Stats();
+
+    Invalidate();
+}
+
+void GlStateCache::Invalidate()
+{
+    program_ = kUnknown;
+    vao_ = kUnknown;
+    for (int i = 0; i < kMaxTextureUnits; ++i) {
+        textures_[i] = kUnknown;
+    }
+    active_unit_ = -1;
+
+    blend_ = -1;
+    blend_src_ = kUnknown;
+    blend_dst_ = kUnknown;
+}
+
+void GlStateCache::UseProgram(GLuint program)
+{
+    if (Check(program_ == program))
+        return;
+
+    program_ = program;
+    glUseProgram(program);
+}
+
+void GlStateCache::BindVertexArray(GLuint vao)
+{
+    if (Check(vao_ == vao))
+        return;
+
+    vao_ = vao;
+    glBindVertexArray(vao);
+}
+
+void GlStateCache::BindTexture(GLuint texture, int unit)
+{
+    if (unit < 0 || unit >= kMaxTextureUnits)
+        return;
+
+    if (Check(textures_[unit] == texture))
+        return;
+
+    if (!Check(active_unit_ == unit)) {
+        active_unit_ = unit;
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+
+    textures_[unit] = texture;
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+void GlStateCache::SetBlend(bool enable)
+{
+    if (Check(blend_ == (int)enable))
+        return;
+
+    blend_ = (int)enable;
+    if (enable) {
+        glEnable(GL_BLEND);
+    } else {
+        glDisable(GL_BLEND);
+    }
+}
+
+void GlStateCache::BlendFunc(GLenum src, GLenum dst)
+{
+    if (Check(blend_src_ == src && blend_dst_ == dst))
+        return;
+
+    blend_src_ = src;
+    blend_dst_ = dst;
+    glBlendFunc(src, dst);
+}
+
+bool GlStateCache::Check(bool is_redundant)
+{
+    if (is_redundant) {
+        ++stats_.elided;
+    } else {
+        ++stats_.issued;
+    }
+
+    return is_redundant;
+}
@@ -0,0 +1,67 @@
+#ifndef GL_STATE_CACHE_H_
+#define GL_STATE_CACHE_H_
+
+#include <QOpenGLExtraFunctions>
+
+#include "singleton.h"
+
+/**
+ * @brief Shadow copy of the GL state the renderers touch. Calls that would not change the state
+ * are skipped and counted. Everything that binds programs, vertex arrays, 2D textures or blend
+ * state during a frame has to go through here, and BeginFrame() drops the shadow state because
+ * Qt may change it between frames.
+ */
+class GlStateCache : protected QOpenGLExtraFunctions
+{
+    SINGLETON_DECLARE(GlStateCache)
+public:
+    struct Stats
+    {
+        int issued = 0;
+        int elided = 0;
+    };
+
+    GlStateCache();
+    ~GlStateCache() = default;
+
+    void BeginFrame();
+    void Invalidate();
+
+    void UseProgram(GLuint program);
+    void BindVertexArray(GLuint vao);
+    void BindTexture(GLuint texture, int unit = 0);
+
+    void SetBlend(bool enable);
+    void BlendFunc(GLenum src, GLenum dst);
+
+    /**
+     * @brief Counts of the last finished frame.
+     */
+    inline Stats LastFrameStats();
+
+private:
+    static constexpr int kMaxTextureUnits = 4;
+    static constexpr GLuint kUnknown = 0xFFFFFFFF;
+
+    bool Check(bool is_redundant);
+
+private:
+    GLuint program_;
+    GLuint vao_;
+    GLuint textures_[kMaxTextureUnits];
+    int active_unit_;
+
+    int blend_; // -1 unknown
+    GLenum blend_src_;
+    GLenum blend_dst_;
+
+    Stats stats_;
+    Stats last_stats_;
+};
+
+inline GlStateCache::Stats GlStateCache::LastFrameStats()
+{
+    return last_stats_;
+}
+
+#endif
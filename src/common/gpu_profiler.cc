@@ -0,0 +1,189 @@
+#include "gpu_profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+GpuProfiler::GpuProfiler(const std::vector<std::string>& stage_names, int window)
+    : is_enabled_(false)
+    , queries_(kLatency * stage_names.size(), 0)
+    , is_pending_(kLatency * stage_names.size(), false)
+    , frame_(0)
+    , slot_(0)
+    , active_stage_(-1)
+    , last_frame_ms_(stage_names.size(), 0.0f)
+    , dropped_(0)
+{
+    initializeOpenGLFunctions();
+
+    for (auto& name : stage_names) {
+        Stage stage = {name, std::vector<float>(std::max(window, 1), 0.0f), 0, 0};
+        stages_.emplace_back(stage);
+    }
+
+    if (!queries_.empty()) {
+        glGenQueries((GLsizei)queries_.size(), queries_.data());
+    }
+}
+
+GpuProfiler::~GpuProfiler()
+{
+    if (!queries_.empty()) {
+        glDeleteQueries((GLsizei)queries_.size(), queries_.data());
+    }
+}
+
+void GpuProfiler::SetEnabled(bool enable)
+{
+    if (is_enabled_ == enable)
+        return;
+
+    // Results still in flight belong to the old session.
+    is_enabled_ = enable;
+    std::fill(is_pending_.begin(), is_pending_.end(), false);
+    for (auto& stage : stages_) {
+        stage.next = 0;
+        stage.count = 0;
+    }
+    dropped_ = 0;
+}
+
+void GpuProfiler::BeginFrame()
+{
+    if (!is_enabled_)
+        return;
+
+    // The oldest slot is reused this frame, take whatever of it has finished.
+    slot_ = frame_ % kLatency;
+    Resolve(slot_, false);
+}
+
+void GpuProfiler::EndFrame()
+{
+    if (!is_enabled_)
+        return;
+
+    ++frame_;
+}
+
+void GpuProfiler::BeginStage(int stage)
+{
+    if (!is_enabled_ || stage < 0 || stage >= (int)stages_.size())
+        return;
+
+    glBeginQuery(GL_TIME_ELAPSED, Query(slot_, stage));
+    active_stage_ = stage;
+}
+
+void GpuProfiler::EndStage()
+{
+    if (!is_enabled_ || active_stage_ < 0)
+        return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    is_pending_[slot_ * stages_.size() + active_stage_] = true;
+    active_stage_ = -1;
+}
+
+void GpuProfiler::Drain()
+{
+    if (!is_enabled_)
+        return;
+
+    // oldest first, so the last frame read is the newest one
+    for (int i = 0; i < kLatency; ++i) {
+        Resolve((frame_ + i) % kLatency, true);
+    }
+}
+
+std::vector<GpuProfiler::StageStats> GpuProfiler::CalcStats()
+{
+    std::vector<StageStats> stats;
+    std::vector<float> sorted;
+    for (auto& stage : stages_) {
+        StageStats stage_stats;
+        stage_stats.name = stage.name;
+        stage_stats.samples = stage.count;
+
+        if (stage.count > 0) {
+            sorted.assign(stage.samples.begin(), stage.samples.begin() + stage.count);
+            std::sort(sorted.begin(), sorted.end());
+
+            float sum = 0.0f;
+            for (float sample : sorted) {
+                sum += sample;
+            }
+            stage_stats.avg_ms = sum / stage.count;
+            stage_stats.p50_ms = sorted[(stage.count - 1) / 2];
+            stage_stats.p95_ms = sorted[(stage.count - 1) * 95 / 100];
+            stage_stats.max_ms = sorted.back();
+        }
+
+        stats.emplace_back(stage_stats);
+    }
+
+    return stats;
+}
+
+bool GpuProfiler::WriteStats(const std::string& file)
+{
+    std::ofstream ofs(file, std::ios_base::out);
+    if (!ofs) {
+        std::cout << "Open gpu stats file fail. path: " << file << std::endl;
+        return false;
+    }
+
+    ofs << "stage,avg_ms,p50_ms,p95_ms,max_ms,samples\n";
+    ofs << std::fixed << std::setprecision(4);
+    for (auto& stage_stats : CalcStats()) {
+        ofs << stage_stats.name << ',' << stage_stats.avg_ms << ',' << stage_stats.p50_ms << ','
+            << stage_stats.p95_ms << ',' << stage_stats.max_ms << ',' << stage_stats.samples
+            << '\n';
+    }
+    ofs << "# dropped," << dropped_ << '\n';
+
+    return true;
+}
+
+GLuint GpuProfiler::Query(int slot, int stage)
+{
+    return queries_[slot * stages_.size() + stage];
+}
+
+void GpuProfiler::Resolve(int slot, bool wait)
+{
+    bool is_frame_read = false;
+    for (size_t stage = 0; stage < stages_.size(); ++stage) {
+        size_t index = slot * stages_.size() + stage;
+        if (!is_pending_[index])
+            continue;
+
+        is_pending_[index] = false;
+
+        if (!wait) {
+            GLint available = 0;
+            glGetQueryObjectiv(queries_[index], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) {
+                // The GPU is more than kLatency frames behind, skip the sample instead of waiting.
+                ++dropped_;
+                continue;
+            }
+        }
+
+        if (!is_frame_read) {
+            std::fill(last_frame_ms_.begin(), last_frame_ms_.end(), 0.0f);
+            is_frame_read = true;
+        }
+
+        GLuint64 elapsed_ns = 0;
+        glGetQueryObjectui64v(queries_[index], GL_QUERY_RESULT, &elapsed_ns);
+        float ms = elapsed_ns / 1e6f;
+        last_frame_ms_[stage] = ms;
+
+        Stage& target = stages_[stage];
+        target.samples[target.next] = ms;
+        target.next = (target.next + 1) % (int)target.samples.size();
+        target.count = std::min(target.count + 1, (int)target.samples.size());
+    }
+}
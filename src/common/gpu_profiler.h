@@ -0,0 +1,92 @@
+#ifndef GPU_PROFILER_H_
+#define GPU_PROFILER_H_
+
+#include <QOpenGLFunctions_3_3_Core>
+#include <string>
+#include <vector>
+
+/**
+ * @brief GPU time per render stage, measured with GL_TIME_ELAPSED queries. Every stage has one
+ * query per frame in flight, results are read kLatency frames later when they are ready, so the
+ * CPU never waits for the GPU. Stages must not nest, the queries of one target cannot overlap.
+ */
+class GpuProfiler : protected QOpenGLFunctions_3_3_Core
+{
+public:
+    static constexpr int kLatency = 3;
+
+    struct StageStats
+    {
+        std::string name;
+        float avg_ms = 0.0f;
+        float p50_ms = 0.0f;
+        float p95_ms = 0.0f;
+        float max_ms = 0.0f;
+        int samples = 0;
+    };
+
+    /**
+     * @param window Samples kept per stage for the averages and percentiles.
+     */
+    GpuProfiler(const std::vector<std::string>& stage_names, int window = 240);
+    ~GpuProfiler();
+
+    void SetEnabled(bool enable);
+    inline bool IsEnabled();
+
+    void BeginFrame();
+    void EndFrame();
+
+    void BeginStage(int stage);
+    void EndStage();
+
+    /**
+     * @brief Wait for every query in flight. Only for offline runs, it stalls the pipeline.
+     */
+    void Drain();
+
+    /**
+     * @brief Stage times of the most recent frame whose results were read.
+     */
+    inline const std::vector<float>& LastFrameMs();
+
+    std::vector<StageStats> CalcStats();
+    bool WriteStats(const std::string& file);
+
+private:
+    struct Stage
+    {
+        std::string name;
+        std::vector<float> samples;
+        int next;
+        int count;
+    };
+
+    GLuint Query(int slot, int stage);
+    void Resolve(int slot, bool wait);
+
+private:
+    bool is_enabled_;
+    std::vector<Stage> stages_;
+
+    std::vector<GLuint> queries_;
+    std::vector<bool> is_pending_;
+    int frame_;
+    int slot_;
+    int active_stage_;
+
+    std::vector<float> last_frame_ms_;
+    int dropped_;
+};
+
+inline bool GpuProfiler::IsEnabled()
+{
+    return is_enabled_;
+}
+
+inline const std::vector<float>& GpuProfiler::LastFrameMs()
+{
+    return last_frame_ms_;
+}
+
+#endif
@@ -1,19 +1,214 @@
 #include "resource_manager.h"
 
-ResourceManager::ResourceManager() {}
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QtConcurrentRun>
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+#include "cooked_texture.h"
+#include "gl_state_cache.h"
+
+// Full mip chain for stand-alone textures.
+constexpr int kMaxMipLevel = 16;
+
+ResourceManager::ResourceManager()
+    : atlas_(std::make_shared<TextureAtlas>())
+    , next_page_(0)
+    , is_atlas_pending_(false)
+{}
 
 std::shared_ptr<QOpenGLTexture> ResourceManager::Texture(const std::string& name,
                                                          const std::string& file, bool alpha)
 {
     auto iter = texture_map_.find(name);
-    if (iter == texture_map_.end()) {
-        auto texture = std::make_shared<QOpenGLTexture>(QOpenGLTexture::Target2D);
-        if (alpha) {
-            texture->setFormat(QOpenGLTexture::RGBAFormat);
+    if (iter != texture_map_.end())
+        return iter->second;
+
+    // A texture that fails to load is not cached, the caller draws without it.
+    auto cooked = CookTexture(name, file, alpha);
+    if (!cooked)
+        return nullptr;
+
+    auto texture = cooked->Upload();
+    texture_map_[name] = texture;
+    return texture;
+}
+
+void ResourceManager::LoadAsync(const QString& atlas_dir,
+                                const std::vector<TextureRequest>& textures)
+{
+    for (auto& request : textures) {
+        if (texture_map_.find(request.name) != texture_map_.end())
+            continue;
+
+        pending_textures_.push_back(
+            {request.name, QtConcurrent::run(CookTexture, request.name, request.file,
+                                             request.alpha)});
+    }
+
+    if (QFileInfo::exists(CookedFile("atlas_0"))) {
+        pending_pages_ = QtConcurrent::run(OpenCookedAtlas);
+        next_page_ = 0;
+        is_atlas_pending_ = true;
+        return;
+    }
+
+    // One task per image, the packing starts when all of them are decoded.
+    QDir image_dir(atlas_dir);
+    for (auto& file : image_dir.entryList(QStringList() << "*.png", QDir::Files, QDir::Name)) {
+        QString path = image_dir.filePath(file);
+        QFuture<QImage> future = QtConcurrent::run([path]() { return QImage(path); });
+        pending_sprites_.push_back({QFileInfo(file).baseName().toStdString(), future});
+    }
+    is_atlas_pending_ = !pending_sprites_.empty();
+}
+
+bool ResourceManager::Upload(int max_uploads)
+{
+    int uploads = 0;
+
+    if (is_atlas_pending_ && StartPacking() && pending_pages_.isFinished()) {
+        std::vector<CookedPtr> pages = pending_pages_.result();
+        for (; next_page_ < pages.size() && uploads < max_uploads; ++next_page_, ++uploads) {
+            CookedPtr& page = pages[next_page_];
+            atlas_->AddPage(page->Upload(), page->Sprites((int)next_page_));
+        }
+
+        if (next_page_ == pages.size()) {
+            is_atlas_pending_ = false;
+            atlas_->PrintStats();
+        }
+    }
+
+    for (auto iter = pending_textures_.begin();
+         iter != pending_textures_.end() && uploads < max_uploads;) {
+        if (!iter->future.isFinished()) {
+            ++iter;
+            continue;
+        }
+
+        CookedPtr cooked = iter->future.result();
+        if (cooked) {
+            texture_map_[iter->name] = cooked->Upload();
+        }
+        iter = pending_textures_.erase(iter);
+        ++uploads;
+    }
+
+    // QOpenGLTexture binds the textures it uploads behind the cache's back.
+    if (uploads > 0) {
+        Singleton<GlStateCache>::Instance()->Invalidate();
+    }
+
+    return !is_atlas_pending_ && pending_textures_.empty();
+}
+
+void ResourceManager::WaitLoaded()
+{
+    for (auto& sprite : pending_sprites_) {
+        sprite.future.waitForFinished();
+    }
+    StartPacking();
+
+    pending_pages_.waitForFinished();
+    for (auto& texture : pending_textures_) {
+        texture.future.waitForFinished();
+    }
+
+    Upload(std::numeric_limits<int>::max());
+}
+
+TextureRegion ResourceManager::Sprite(const std::string& name)
+{
+    return atlas_->Region(name);
+}
+
+ResourceManager::CookedPtr ResourceManager::CookTexture(const std::string& name,
+                                                        const std::string& file, bool alpha)
+{
+    auto cooked = std::make_shared<CookedTexture>();
+    if (cooked->Open(CookedFile(QString::fromStdString(name))))
+        return cooked;
+
+    QImage image(file.c_str());
+    if (image.isNull()) {
+        std::cout << "Texture image is null. name: " << name << " path: " << file << std::endl;
+        return nullptr;
+    }
+
+    if (!alpha) {
+        image = image.convertToFormat(QImage::Format_RGB32);
+    }
+    if (!cooked->Load(CookedTexture::Cook(image, kMaxMipLevel)))
+        return nullptr;
+
+    return cooked;
+}
+
+std::vector<ResourceManager::CookedPtr> ResourceManager::CookAtlas(
+    const std::vector<NamedImage>& images)
+{
+    TextureAtlas atlas;
+    for (auto& image : images) {
+        atlas.Add(image.first, image.second);
+    }
+
+    std::vector<CookedPtr> pages;
+    std::vector<QByteArray> blobs = atlas.Cook();
+    for (size_t page = 0; page < blobs.size(); ++page) {
+        auto cooked = std::make_shared<CookedTexture>();
+        if (!cooked->Load(blobs[page])) {
+            std::cout << "Atlas page is invalid. page: " << page << std::endl;
+            continue;
         }
-        texture->setData(QImage(file.c_str()));
-        texture_map_[name] = texture;
+        pages.emplace_back(cooked);
     }
 
-    return texture_map_[name];
+    return pages;
+}
+
+std::vector<ResourceManager::CookedPtr> ResourceManager::OpenCookedAtlas()
+{
+    std::vector<CookedPtr> pages;
+    for (int page = 0;; ++page) {
+        auto cooked = std::make_shared<CookedTexture>();
+        if (!cooked->Open(CookedFile(QString("atlas_%1").arg(page))))
+            break;
+
+        pages.emplace_back(cooked);
+    }
+
+    return pages;
+}
+
+QString ResourceManager::CookedFile(const QString& name)
+{
+    return QCoreApplication::applicationDirPath() + "/cooked/" + name + ".ctex";
+}
+
+bool ResourceManager::StartPacking()
+{
+    if (pending_sprites_.empty())
+        return true;
+
+    bool is_decoded = std::all_of(pending_sprites_.begin(), pending_sprites_.end(),
+                                  [](const PendingSprite& sprite) {
+                                      return sprite.future.isFinished();
+                                  });
+    if (!is_decoded)
+        return false;
+
+    std::vector<NamedImage> images;
+    for (auto& sprite : pending_sprites_) {
+        images.emplace_back(sprite.name, sprite.future.result());
+    }
+    pending_sprites_.clear();
+
+    pending_pages_ = QtConcurrent::run(CookAtlas, images);
+    next_page_ = 0;
+
+    return true;
 }
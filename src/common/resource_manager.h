@@ -1,23 +1,96 @@
 #ifndef RESOURCE_MANAGER_H_
 #define RESOURCE_MANAGER_H_
 
+#include <QFuture>
 #include <QOpenGLTexture>
 #include <unordered_map>
+#include <vector>
 
 #include "singleton.h"
+#include "texture_atlas.h"
+
+class CookedTexture;
 
 class ResourceManager
 {
     SINGLETON_DECLARE(ResourceManager)
 public:
+    struct TextureRequest
+    {
+        std::string name;
+        std::string file;
+        bool alpha;
+    };
+
     ResourceManager();
     ~ResourceManager() = default;
 
+    /**
+     * @brief Uses <name>.ctex from the cooked directory when it exists, otherwise the image file
+     * is decoded and cooked now. Textures are premultiplied.
+     */
     std::shared_ptr<QOpenGLTexture> Texture(const std::string& name, const std::string& file,
                                             bool alpha);
 
+    /**
+     * @brief Decode the textures and the sprite atlas of the directory (every png, keyed by base
+     * name) on the thread pool. Pages cooked offline (atlas_<n>.ctex) are mapped instead when
+     * they exist. Nothing touches GL until Upload().
+     */
+    void LoadAsync(const QString& atlas_dir, const std::vector<TextureRequest>& textures);
+
+    /**
+     * @brief Upload what the workers have finished, at most max_uploads textures per call so a
+     * frame is not stalled for long. Every atlas page counts as one texture, the atlas pages go
+     * first. Requires a current GL context.
+     * @return True when everything requested by LoadAsync() is uploaded.
+     */
+    bool Upload(int max_uploads);
+
+    /**
+     * @brief Loading barrier, waits for the workers and uploads everything.
+     */
+    void WaitLoaded();
+
+    TextureRegion Sprite(const std::string& name);
+
+private:
+    using CookedPtr = std::shared_ptr<CookedTexture>;
+    using NamedImage = std::pair<std::string, QImage>;
+
+    struct PendingTexture
+    {
+        std::string name;
+        QFuture<CookedPtr> future;
+    };
+
+    struct PendingSprite
+    {
+        std::string name;
+        QFuture<QImage> future;
+    };
+
+    // run on the thread pool, CookTexture() returns null when the image fails to decode
+    static CookedPtr CookTexture(const std::string& name, const std::string& file, bool alpha);
+    static std::vector<CookedPtr> CookAtlas(const std::vector<NamedImage>& images);
+    static std::vector<CookedPtr> OpenCookedAtlas();
+
+    static QString CookedFile(const QString& name);
+
+    /**
+     * @return True once the sprites are decoded and packing has started.
+     */
+    bool StartPacking();
+
 private:
     std::unordered_map<std::string, std::shared_ptr<QOpenGLTexture>> texture_map_;
+    std::shared_ptr<TextureAtlas> atlas_;
+
+    std::vector<PendingTexture> pending_textures_;
+    std::vector<PendingSprite> pending_sprites_;
+    QFuture<std::vector<CookedPtr>> pending_pages_;
+    size_t next_page_; // first page of pending_pages_ not uploaded yet
+    bool is_atlas_pending_;
 };
 
 #endif
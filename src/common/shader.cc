@@ -1,142 +1,133 @@
-#include "Shader.h"
+#include "shader.h"
 
-#include <fstream>
+#include <QElapsedTimer>
 #include <iostream>
-#include <sstream>
 #include <string>
 
+#include "gl_state_cache.h"
+#include "shader_cache.h"
+
 //#include "glad/glad.h"
 
 AbstractShader::AbstractShader(const char* vertexPath, const char* geometryPath, const char* fragmentPath)
 {
     initializeOpenGLFunctions();
 
-    // compile vertex shader
-    std::fstream vertexStream(vertexPath, std::ios_base::in);
-    if (!vertexStream.is_open()) {
-        std::cout << "Open vertex shader file fail. path: " << vertexPath << std::endl;
-    }
-
-    std::stringstream strVertexStream;
-    strVertexStream << vertexStream.rdbuf();
-    vertexStream.close();
+    QElapsedTimer timer;
+    timer.start();
 
-    std::string tmpSouce = strVertexStream.str(); // תstd::string, c_str, 
-    const char* vertexSource = tmpSouce.c_str();
+    QByteArray vertexSource = ShaderCache::ReadSource(vertexPath);
+    QByteArray geometrySource = geometryPath ? ShaderCache::ReadSource(geometryPath) : QByteArray();
+    QByteArray fragmentSource = ShaderCache::ReadSource(fragmentPath);
 
-    unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexSource, NULL);
-    glCompileShader(vertexShader);
+    // link from the cached binary when the sources and the driver are unchanged
+    auto shaderCache = Singleton<ShaderCache>::Instance();
+    QByteArray key = shaderCache->Key({vertexSource, geometrySource, fragmentSource});
 
-    int success;
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "vertex shader compile fail. reason: " << infoLog << std::endl;
+    m_id = glCreateProgram();
+    if (shaderCache->Load(m_id, key)) {
+        shaderCache->Record(vertexPath, timer.nsecsElapsed() / 1e6, true);
+        return;
     }
 
+    // compile vertex shader
+    unsigned int vertexShader = compileShader(GL_VERTEX_SHADER, vertexSource, "vertex");
+
     // compile geometry shader (optional)
-    unsigned int geometryShader;
+    unsigned int geometryShader = 0;
     if (geometryPath) {
-        std::fstream geometryStream(geometryPath, std::ios_base::in);
-        if (!geometryStream.is_open()) {
-            std::cout << "Open geometry shader file fail. path: " << fragmentPath << std::endl;
-        }
-        std::stringstream strGeometryStream;
-        strGeometryStream << geometryStream.rdbuf();
-        geometryStream.close();
-
-        tmpSouce = strGeometryStream.str(); // תstd::string, c_str, 
-        const char* geometrySource = tmpSouce.c_str();
-
-        geometryShader = glCreateShader(GL_GEOMETRY_SHADER);
-        glShaderSource(geometryShader, 1, &geometrySource, NULL);
-        glCompileShader(geometryShader);
-
-        glGetShaderiv(geometryShader, GL_COMPILE_STATUS, &success);
-        if (!success) {
-            char infoLog[512];
-            glGetShaderInfoLog(geometryShader, 512, NULL, infoLog);
-            std::cout << "geometry shader compile fail. reason: " << infoLog << std::endl;
-        }
+        geometryShader = compileShader(GL_GEOMETRY_SHADER, geometrySource, "geometry");
     }
 
     // compile fragment shader
-    std::fstream fragmentStream(fragmentPath, std::ios_base::in);
-    if (!fragmentStream.is_open()) {
-        std::cout << "Open fragment shader file fail. path: " << fragmentPath << std::endl;
-    }
-
-    std::stringstream strFragmentStream;
-    strFragmentStream << fragmentStream.rdbuf();
-    fragmentStream.close();
-
-    tmpSouce = strFragmentStream.str(); // תstd::string, c_str, 
-    const char* fragmentSource = tmpSouce.c_str();
-
-    unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentSource, NULL);
-    glCompileShader(fragmentShader);
-
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "fragment shader compile fail. reason: " << infoLog << std::endl;
-    }
+    unsigned int fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource, "fragment");
 
     // link shader program
-    m_id = glCreateProgram();
     glAttachShader(m_id, vertexShader);
     if (geometryPath) {
         glAttachShader(m_id, geometryShader);
     }
     glAttachShader(m_id, fragmentShader);
+    shaderCache->SetRetrievable(m_id);
     glLinkProgram(m_id);
 
+    int success;
+    glGetProgramiv(m_id, GL_LINK_STATUS, &success);
+    if (success) {
+        shaderCache->Store(m_id, key);
+    } else {
+        char infoLog[512];
+        glGetProgramInfoLog(m_id, 512, NULL, infoLog);
+        std::cout << "shader program link fail. reason: " << infoLog << std::endl;
+    }
+
     glDeleteShader(vertexShader);
+    if (geometryPath) {
+        glDeleteShader(geometryShader);
+    }
     glDeleteShader(fragmentShader);
+
+    shaderCache->Record(vertexPath, timer.nsecsElapsed() / 1e6, false);
 }
 
 AbstractShader::~AbstractShader()
 {
-    glDeleteShader(m_id);
+    glDeleteProgram(m_id);
+}
+
+unsigned int AbstractShader::compileShader(unsigned int type, const QByteArray& source,
+                                           const char* typeName)
+{
+    const char* sourceData = source.constData();
+
+    unsigned int shader = glCreateShader(type);
+    glShaderSource(shader, 1, &sourceData, NULL);
+    glCompileShader(shader);
+
+    int success;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        char infoLog[512];
+        glGetShaderInfoLog(shader, 512, NULL, infoLog);
+        std::cout << typeName << " shader compile fail. reason: " << infoLog << std::endl;
+    }
+
+    return shader;
 }
 
 void AbstractShader::setBool(const std::string& name, bool value)
 {
-    glUniform1i(glGetUniformLocation(m_id, name.c_str()), (int)value);
+    glUniform1i(uniformLocation(name), (int)value);
 }
 
 void AbstractShader::setInt(const std::string& name, int value)
 {
-    glUniform1i(glGetUniformLocation(m_id, name.c_str()), value);
+    glUniform1i(uniformLocation(name), value);
 }
 
 void AbstractShader::setFloat(const std::string& name, float value)
 {
-    glUniform1f(glGetUniformLocation(m_id, name.c_str()), value);
+    glUniform1f(uniformLocation(name), value);
 }
 
 void AbstractShader::setFloat(const std::string& name, float v1, float v2, float v3, float v4)
 {
-    glUniform4f(glGetUniformLocation(m_id, name.c_str()), v1, v2, v3, v4);
+    glUniform4f(uniformLocation(name), v1, v2, v3, v4);
 }
 
 void AbstractShader::setVec(const std::string& name, float v1, float v2)
 {
-    glUniform2f(glGetUniformLocation(m_id, name.c_str()), v1, v2);
+    glUniform2f(uniformLocation(name), v1, v2);
 }
 
 void AbstractShader::setVec(const std::string& name, float v1, float v2, float v3)
 {
-    glUniform3f(glGetUniformLocation(m_id, name.c_str()), v1, v2, v3);
+    glUniform3f(uniformLocation(name), v1, v2, v3);
 }
 
 void AbstractShader::setVec(const std::string& name, float v1, float v2, float v3, float v4)
 {
-    glUniform4f(glGetUniformLocation(m_id, name.c_str()), v1, v2, v3, v4);
+    glUniform4f(uniformLocation(name), v1, v2, v3, v4);
 }
 
 void AbstractShader::setVec(const std::string& name, glm::vec2 vec)
@@ -156,17 +147,17 @@ void AbstractShader::setVec(const std::string& name, glm::vec4 vec)
 
 void AbstractShader::setMatrix(const std::string& name, float* value)
 {
-    glUniformMatrix4fv(glGetUniformLocation(m_id, name.c_str()), 1, GL_FALSE, value);
+    glUniformMatrix4fv(uniformLocation(name), 1, GL_FALSE, value);
 }
 
 void AbstractShader::setMatrix(const std::string& name, glm::mat3 value)
 {
-    glUniformMatrix3fv(glGetUniformLocation(m_id, name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
+    glUniformMatrix3fv(uniformLocation(name), 1, GL_FALSE, glm::value_ptr(value));
 }
 
 void AbstractShader::setMatrix(const std::string& name, glm::mat4 value)
 {
-    glUniformMatrix4fv(glGetUniformLocation(m_id, name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
+    glUniformMatrix4fv(uniformLocation(name), 1, GL_FALSE, glm::value_ptr(value));
 }
 
 void AbstractShader::setUniformBlockBinding(const std::string& name, unsigned int value)
@@ -174,11 +165,23 @@ void AbstractShader::setUniformBlockBinding(const std::string& name, unsigned in
     glUniformBlockBinding(m_id, glGetUniformBlockIndex(m_id, name.c_str()), value);
 }
 
+int AbstractShader::uniformLocation(const std::string& name)
+{
+    auto iter = m_uniformLocations.find(name);
+    if (iter != m_uniformLocations.end())
+        return iter->second;
+
+    int location = glGetUniformLocation(m_id, name.c_str());
+    m_uniformLocations.emplace(name, location);
+
+    return location;
+}
+
 SimpleShader::SimpleShader(const char* vertexPath, const char* geometryPath, const char* fragmentPath)
     : AbstractShader(vertexPath, geometryPath, fragmentPath)
 {}
 
 void SimpleShader::bind()
 {
-    glUseProgram(m_id);
+    Singleton<GlStateCache>::Instance()->UseProgram(m_id);
 }
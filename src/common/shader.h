@@ -1,8 +1,10 @@
 #ifndef SHADER_H_
 #define SHADER_H_
 
+#include <QByteArray>
 #include <QOpenGLExtraFunctions>
 #include <string>
+#include <unordered_map>
 
 #include "gtc/type_ptr.hpp"
 
@@ -37,8 +39,17 @@ public:
 
     void setUniformBlockBinding(const std::string& name, unsigned int value);
 
+    /**
+     * @brief Resolved on first use and cached, unknown names cache -1.
+     */
+    int uniformLocation(const std::string& name);
+
+protected:
+    unsigned int compileShader(unsigned int type, const QByteArray& source, const char* typeName);
+
 protected:
     unsigned int m_id;
+    std::unordered_map<std::string, int> m_uniformLocations;
 };
 
 /**
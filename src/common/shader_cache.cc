@@ -0,0 +1,223 @@
+#include "shader_cache.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QOpenGLContext>
+#include <QStandardPaths>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+// Part of the key, bump it when the file layout changes.
+static const char kCacheVersion[] = "shader-cache-1";
+
+ShaderCache::ShaderCache()
+    : is_supported_(false)
+{
+    initializeOpenGLFunctions();
+
+    auto context = QOpenGLContext::currentContext();
+    auto version = context->format().version();
+    bool has_program_binary = version >= qMakePair(4, 1) ||
+                              context->hasExtension("GL_ARB_get_program_binary");
+
+    GLint format_count = 0;
+    if (has_program_binary) {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+    }
+
+    // Some drivers support the calls but no format.
+    is_supported_ = format_count > 0;
+
+    driver_ = QByteArray((const char*)glGetString(GL_VENDOR)) + '\n' +
+              QByteArray((const char*)glGetString(GL_RENDERER)) + '\n' +
+              QByteArray((const char*)glGetString(GL_VERSION));
+
+    cache_dir_ = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/shaders";
+    if (is_supported_ && !QDir().mkpath(cache_dir_)) {
+        std::cout << "Create shader cache dir fail. path: " << cache_dir_.toStdString()
+                  << std::endl;
+        is_supported_ = false;
+    }
+}
+
+QByteArray ShaderCache::ReadSource(const QString& file)
+{
+    QFile source_file(file);
+    if (!source_file.open(QIODevice::ReadOnly)) {
+        std::cout << "Open shader file fail. path: " << file.toStdString() << std::endl;
+        return QByteArray();
+    }
+
+    return source_file.readAll();
+}
+
+bool ShaderCache::Build(QOpenGLShaderProgram* program, const std::string& name,
+                        const std::vector<Source>& sources,
+                        const std::vector<const char*>& varyings)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    std::vector<QByteArray> key_parts;
+    for (auto& source : sources) {
+        key_parts.emplace_back(QByteArray::number((int)source.type) + '\n' + source.code);
+    }
+    for (auto varying : varyings) {
+        key_parts.emplace_back(varying);
+    }
+    QByteArray key = Key(key_parts);
+
+    program->create();
+
+    // link() without shaders only checks the link status of the loaded binary.
+    if (Load(program->programId(), key) && program->link()) {
+        Record(name, timer.nsecsElapsed() / 1e6, true);
+        return true;
+    }
+
+    for (auto& source : sources) {
+        if (!program->addShaderFromSourceCode(source.type, source.code)) {
+            std::cout << name << " shader compile fail. reason: " << program->log().toStdString()
+                      << std::endl;
+        }
+    }
+
+    if (!varyings.empty()) {
+        glTransformFeedbackVaryings(program->programId(), (GLsizei)varyings.size(),
+                                    varyings.data(), GL_INTERLEAVED_ATTRIBS);
+    }
+
+    SetRetrievable(program->programId());
+    bool is_linked = program->link();
+    if (is_linked) {
+        Store(program->programId(), key);
+    } else {
+        std::cout << name << " program link fail. reason: " << program->log().toStdString()
+                  << std::endl;
+    }
+
+    Record(name, timer.nsecsElapsed() / 1e6, false);
+
+    return is_linked;
+}
+
+QByteArray ShaderCache::Key(const std::vector<QByteArray>& sources)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(kCacheVersion);
+    hash.addData(driver_);
+    for (auto& source : sources) {
+        // the size keeps the boundaries between sources in the key
+        hash.addData(QByteArray::number(source.size()));
+        hash.addData(source);
+    }
+
+    return hash.result().toHex();
+}
+
+bool ShaderCache::Load(GLuint program, const QByteArray& key)
+{
+    if (!is_supported_)
+        return false;
+
+    QFile file(CacheFile(key));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QByteArray data = file.readAll();
+    file.close();
+
+    GLenum format = 0;
+    if (data.size() <= (int)sizeof(format)) {
+        file.remove();
+        return false;
+    }
+    memcpy(&format, data.constData(), sizeof(format));
+
+    glProgramBinary(program, format, data.constData() + sizeof(format),
+                    data.size() - (GLsizei)sizeof(format));
+
+    GLint is_linked = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &is_linked);
+    if (!is_linked) {
+        // Driver update or a different GPU, the program is rebuilt and stored again.
+        std::cout << "Cached program rejected. key: " << key.toStdString() << std::endl;
+        file.remove();
+        return false;
+    }
+
+    return true;
+}
+
+void ShaderCache::Store(GLuint program, const QByteArray& key)
+{
+    if (!is_supported_)
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    GLenum format = 0;
+    QByteArray data(sizeof(format) + length, Qt::Uninitialized);
+    glGetProgramBinary(program, length, nullptr, &format, data.data() + sizeof(format));
+    memcpy(data.data(), &format, sizeof(format));
+
+    // Written aside and renamed, a crash never leaves a truncated binary behind.
+    QString path = CacheFile(key);
+    QFile file(path + ".tmp");
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size()) {
+        std::cout << "Write shader cache fail. path: " << file.fileName().toStdString()
+                  << std::endl;
+        return;
+    }
+    file.close();
+
+    QFile::remove(path);
+    file.rename(path);
+}
+
+void ShaderCache::SetRetrievable(GLuint program)
+{
+    if (is_supported_) {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+}
+
+void ShaderCache::Record(const std::string& name, double ms, bool is_hit)
+{
+    timings_.push_back({name, ms, is_hit});
+}
+
+void ShaderCache::PrintStats()
+{
+    int hits = 0;
+    double hit_ms = 0.0;
+    double build_ms = 0.0;
+    for (auto& timing : timings_) {
+        if (timing.is_hit) {
+            ++hits;
+            hit_ms += timing.ms;
+        } else {
+            build_ms += timing.ms;
+        }
+    }
+
+    int builds = (int)timings_.size() - hits;
+    std::cout << std::fixed << std::setprecision(2) << "Shader cache"
+              << (is_supported_ ? "" : " (unsupported)") << ": " << hits << " hits " << hit_ms
+              << " ms, " << builds << " compiled and linked " << build_ms << " ms" << std::endl;
+    for (auto& timing : timings_) {
+        std::cout << "  " << std::left << std::setw(24) << timing.name << std::right
+                  << (timing.is_hit ? "hit   " : "build ") << timing.ms << " ms" << std::endl;
+    }
+}
+
+QString ShaderCache::CacheFile(const QByteArray& key)
+{
+    return cache_dir_ + "/" + QString::fromLatin1(key) + ".bin";
+}
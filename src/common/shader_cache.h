@@ -0,0 +1,82 @@
+#ifndef SHADER_CACHE_H_
+#define SHADER_CACHE_H_
+
+#include <QByteArray>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLShaderProgram>
+#include <string>
+#include <vector>
+
+#include "singleton.h"
+
+/**
+ * @brief Persistent cache of linked program binaries (glGetProgramBinary), so later launches
+ * skip compiling and linking. A binary is keyed by the sha1 of the program's sources and of the
+ * driver (vendor, renderer, version). A binary the driver rejects is deleted and the program is
+ * built from source again.
+ *
+ * Every build is timed, so cache hits can be compared with compiling and linking.
+ */
+class ShaderCache : protected QOpenGLExtraFunctions
+{
+    SINGLETON_DECLARE(ShaderCache)
+public:
+    struct Source
+    {
+        QOpenGLShader::ShaderType type;
+        QByteArray code;
+    };
+
+    struct Timing
+    {
+        std::string name;
+        double ms;
+        bool is_hit;
+    };
+
+    ShaderCache();
+    ~ShaderCache() = default;
+
+    /**
+     * @brief Reads files from the resources as well as from disk.
+     */
+    static QByteArray ReadSource(const QString& file);
+
+    /**
+     * @brief Link the program from its cached binary, or compile and link the sources and cache
+     * the result.
+     * @param varyings Transform feedback outputs, captured interleaved. They are part of the key.
+     */
+    bool Build(QOpenGLShaderProgram* program, const std::string& name,
+               const std::vector<Source>& sources,
+               const std::vector<const char*>& varyings = std::vector<const char*>());
+
+    // For programs built with raw GL calls. Load() leaves a linked program or returns false,
+    // Store() expects a program linked with the retrievable hint set.
+    QByteArray Key(const std::vector<QByteArray>& sources);
+    bool Load(GLuint program, const QByteArray& key);
+    void Store(GLuint program, const QByteArray& key);
+    void SetRetrievable(GLuint program);
+    void Record(const std::string& name, double ms, bool is_hit);
+
+    void PrintStats();
+
+    inline bool IsSupported();
+
+private:
+    QString CacheFile(const QByteArray& key);
+
+private:
+    bool is_supported_;
+    QString cache_dir_;
+    QByteArray driver_;
+
+    std::vector<Timing> timings_;
+};
+
+inline bool ShaderCache::IsSupported()
+{
+    return is_supported_;
+}
+
+#endif
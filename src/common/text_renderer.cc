@@ -1,23 +1,44 @@
 #include "text_renderer.h"
 
+#include <algorithm>
 #include <iostream>
 
+#include "frame_uniforms.h"
 #include "ft2build.h"
 #include FT_FREETYPE_H
-#include "gtc/matrix_transform.hpp"
+
+// Glyphs are packed in rows of this width, the atlas height follows from the font size.
+static const int kAtlasWidth = 512;
+static const int kGlyphPadding = 1;
 
 TextRenderer::TextRenderer()
-    : is_origin_bottom_(true)
+    : vao_(0)
+    , vbo_(0)
+    , atlas_texture_(0)
+    , is_origin_bottom_(true)
+    , font_height_(0)
+    , gl_state_(Singleton<GlStateCache>::Instance())
 {
     initializeOpenGLFunctions();
 
     shader_ =
         std::make_unique<SimpleShader>("res/shaders/text.vert", nullptr, "res/shaders/text.frag");
+    shader_->setUniformBlockBinding("Frame", FrameUniforms::kBindingPoint);
 
     InitRenderData();
 }
 
-TextRenderer::~TextRenderer() {}
+TextRenderer::~TextRenderer()
+{
+    glDeleteVertexArrays(1, &vao_);
+    glDeleteBuffers(1, &vbo_);
+    glDeleteTextures(1, &atlas_texture_);
+
+    for (auto& label : labels_) {
+        glDeleteVertexArrays(1, &label.vao);
+        glDeleteBuffers(1, &label.vbo);
+    }
+}
 
 void TextRenderer::Load(const char* font_file, GLuint font_size)
 {
@@ -37,6 +58,19 @@ void TextRenderer::Load(const char* font_file, GLuint font_size)
     // ÿʹ4ֽڣÿֻһֽڣĿȡͨѹΪ1ȷж
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1); //ֽڶ
 
+    struct GlyphBitmap
+    {
+        int x;
+        int y;
+        std::vector<unsigned char> pixels;
+    };
+    std::map<char, GlyphBitmap> bitmaps;
+
+    // Shelf pack the glyphs in code order, the rows are as high as the tallest glyph.
+    int pen_x = kGlyphPadding;
+    int pen_y = kGlyphPadding;
+    int row_height = 0;
+
     for (GLubyte c = 0; c < 128; c++) {
         // ַ(8λĻҶλͼ)
         if (FT_Load_Char(face, c, FT_LOAD_RENDER) != 0) {
@@ -44,25 +78,62 @@ void TextRenderer::Load(const char* font_file, GLuint font_size)
             continue;
         }
 
-        GLuint textureId;
-        glGenTextures(1, &textureId);
-        glBindTexture(GL_TEXTURE_2D, textureId);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, face->glyph->bitmap.width, face->glyph->bitmap.rows,
-                     0, GL_RED, GL_UNSIGNED_BYTE, face->glyph->bitmap.buffer);
+        const FT_Bitmap& bitmap = face->glyph->bitmap;
+        int w = (int)bitmap.width;
+        int h = (int)bitmap.rows;
+        if (pen_x + w + kGlyphPadding > kAtlasWidth) {
+            pen_x = kGlyphPadding;
+            pen_y += row_height + kGlyphPadding;
+            row_height = 0;
+        }
 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        GlyphBitmap glyph = {pen_x, pen_y, std::vector<unsigned char>(w * h)};
+        for (int row = 0; row < h; ++row) {
+            std::copy(bitmap.buffer + row * bitmap.pitch, bitmap.buffer + row * bitmap.pitch + w,
+                      glyph.pixels.begin() + row * w);
+        }
+        bitmaps[c] = std::move(glyph);
 
-        Character character = {textureId,
-                               glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
+        Character character = {glm::vec4(pen_x, pen_y, pen_x + w, pen_y + h),
+                               glm::ivec2(w, h),
                                glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
                                static_cast<unsigned int>(face->glyph->advance.x)};
-        characters_.insert(std::pair<GLchar, Character>(c, character));
+        characters_[c] = character;
+
+        pen_x += w + kGlyphPadding;
+        row_height = std::max(row_height, h);
+    }
+
+    int atlas_height = pen_y + row_height + kGlyphPadding;
+    std::vector<unsigned char> atlas(kAtlasWidth * atlas_height, 0);
+    for (auto& item : bitmaps) {
+        const Character& ch = characters_[item.first];
+        const GlyphBitmap& glyph = item.second;
+        for (int row = 0; row < ch.size.y; ++row) {
+            std::copy(glyph.pixels.begin() + row * ch.size.x,
+                      glyph.pixels.begin() + (row + 1) * ch.size.x,
+                      atlas.begin() + (glyph.y + row) * kAtlasWidth + glyph.x);
+        }
+    }
+
+    // pixel rects to texture coordinates
+    for (auto& item : characters_) {
+        item.second.tex_rect /= glm::vec4(kAtlasWidth, atlas_height, kAtlasWidth, atlas_height);
     }
 
-    glBindTexture(GL_TEXTURE_2D, 0);
+    if (atlas_texture_ == 0) {
+        glGenTextures(1, &atlas_texture_);
+    }
+    gl_state_->BindTexture(atlas_texture_);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, kAtlasWidth, atlas_height, 0, GL_RED, GL_UNSIGNED_BYTE,
+                 atlas.data());
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    gl_state_->BindTexture(0);
 
     FT_Done_Face(face);
     FT_Done_FreeType(ft);
@@ -71,22 +142,29 @@ void TextRenderer::Load(const char* font_file, GLuint font_size)
 void TextRenderer::InitRenderData()
 {
     glEnable(GL_CULL_FACE);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    gl_state_->SetBlend(true);
+    gl_state_->BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    glGenVertexArrays(1, &vao_);
-    glBindVertexArray(vao_);
+    CreateVertexArray(vao_, vbo_);
+}
 
-    glGenBuffers(1, &vbo_);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-    // עַҪVBOڴ棬ڴΪ̬ƣGL_DYNAMIC_DRAW
-    glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
+void TextRenderer::CreateVertexArray(GLuint& vao, GLuint& vbo)
+{
+    glGenVertexArrays(1, &vao);
+    gl_state_->BindVertexArray(vao);
+
+    glGenBuffers(1, &vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
 
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (void*)0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)0);
+
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(TextVertex),
+                          (void*)(4 * sizeof(GLfloat)));
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    gl_state_->BindVertexArray(0);
 }
 
 void TextRenderer::Resize(GLint w, GLint h)
@@ -113,13 +191,78 @@ float TextRenderer::TextWidth(const std::string& text, GLfloat scale)
 void TextRenderer::RenderText(const std::string& text, GLfloat x, GLfloat y, GLfloat scale,
                               glm::vec3 color)
 {
-    shader_->bind();
-    // use floats to make ortho mat.
-    shader_->setMatrix("projectionMat", glm::ortho(0.0f, window_size_.x, 0.0f, window_size_.y));
-    shader_->setVec("textColor", color);
+    AppendQuads(text, x, y, scale, color, vertices_);
+}
+
+void TextRenderer::Flush()
+{
+    if (vertices_.empty())
+        return;
+
+    BindDrawState();
+
+    gl_state_->BindVertexArray(vao_);
+
+    // עַҪVBOڴ棬ÿ·
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(TextVertex) * vertices_.size(), vertices_.data(),
+                 GL_STREAM_DRAW);
 
-    glBindVertexArray(vao_);
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)vertices_.size());
 
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    vertices_.clear();
+}
+
+TextRenderer::TextHandle TextRenderer::CreateText()
+{
+    TextLabel label = {std::string(), glm::vec3(0.0f), glm::vec3(0.0f), 0, 0, 0};
+    CreateVertexArray(label.vao, label.vbo);
+    labels_.emplace_back(label);
+
+    return (TextHandle)labels_.size() - 1;
+}
+
+void TextRenderer::SetText(TextHandle handle, const std::string& text, GLfloat x, GLfloat y,
+                           GLfloat scale, glm::vec3 color)
+{
+    if (handle < 0 || handle >= (TextHandle)labels_.size())
+        return;
+
+    TextLabel& label = labels_[handle];
+    glm::vec3 layout(x, y, scale);
+    if (label.count > 0 && label.text == text && label.layout == layout && label.color == color)
+        return;
+
+    label.text = text;
+    label.layout = layout;
+    label.color = color;
+
+    std::vector<TextVertex> vertices;
+    AppendQuads(text, x, y, scale, color, vertices);
+    label.count = (GLsizei)vertices.size();
+
+    glBindBuffer(GL_ARRAY_BUFFER, label.vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(TextVertex) * vertices.size(), vertices.data(),
+                 GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void TextRenderer::RenderText(TextHandle handle)
+{
+    if (handle < 0 || handle >= (TextHandle)labels_.size() || labels_[handle].count == 0)
+        return;
+
+    BindDrawState();
+
+    gl_state_->BindVertexArray(labels_[handle].vao);
+    glDrawArrays(GL_TRIANGLES, 0, labels_[handle].count);
+}
+
+void TextRenderer::AppendQuads(const std::string& text, GLfloat x, GLfloat y, GLfloat scale,
+                               glm::vec3 color, std::vector<TextVertex>& vertices)
+{
     for (auto c = text.begin(); c != text.end(); c++) {
         Character ch = characters_[*c];
 
@@ -134,30 +277,30 @@ void TextRenderer::RenderText(const std::string& text, GLfloat x, GLfloat y, GLf
         GLfloat w = ch.size.x * scale;
         GLfloat h = ch.size.y * scale;
 
+        const glm::vec4& uv = ch.tex_rect;
+
         // clang-format off
-        GLfloat vertices[6][4] = {
-			{xpos, ypos + h, 0.0, 0.0},    
-			{xpos, ypos, 0.0, 1.0},
-			{xpos + w, ypos, 1.0, 1.0},
-			{xpos, ypos + h, 0.0, 0.0},   
-			{xpos + w, ypos, 1.0, 1.0},
-			{xpos + w, ypos + h, 1.0, 0.0}
+        TextVertex quad[6] = {
+			{{xpos, ypos + h, uv.x, uv.y}, {color.r, color.g, color.b}},
+			{{xpos, ypos, uv.x, uv.w}, {color.r, color.g, color.b}},
+			{{xpos + w, ypos, uv.z, uv.w}, {color.r, color.g, color.b}},
+			{{xpos, ypos + h, uv.x, uv.y}, {color.r, color.g, color.b}},
+			{{xpos + w, ypos, uv.z, uv.w}, {color.r, color.g, color.b}},
+			{{xpos + w, ypos + h, uv.z, uv.y}, {color.r, color.g, color.b}}
 		};
         // clang-format on
-
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, ch.textureId);
-
-        glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        vertices.insert(vertices.end(), quad, quad + 6);
 
         // λõһεԭ㣬advanceλ1/64
         x += (ch.advance >> 6) * scale; // λƫ6λȡλΪصֵ (2^6 = 64)
     }
+}
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+void TextRenderer::BindDrawState()
+{
+    // the projection comes from the shared Frame block
+    shader_->bind();
+    gl_state_->SetBlend(true);
+    gl_state_->BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    gl_state_->BindTexture(atlas_texture_);
 }
@@ -2,21 +2,33 @@
 #define TEXT_LOADER_H_
 
 #include <QOpenGLExtraFunctions>
+#include <vector>
 
+#include "gl_state_cache.h"
 #include "shader.h"
 #include "glm.hpp"
 
 struct Character
 {
-    GLuint textureId;   // ID
+    glm::vec4 tex_rect; // glyph rect in the atlas, (u0, v0, u1, v1)
     glm::ivec2 size;    // δС
     glm::ivec2 bearing; // ӻ׼ߵ/ƫֵ
     GLuint advance;     // ԭһԭľ
 };
 
+/**
+ * @brief All glyphs live in one atlas texture. RenderText() only queues quads, Flush() draws the
+ * text queued so far in one call.
+ *
+ * Text that rarely changes should use a handle from CreateText() instead: its quads are kept in
+ * their own buffer, only rebuilt when SetText() is called with different content, and drawn by
+ * RenderText(handle).
+ */
 class TextRenderer : protected QOpenGLExtraFunctions
 {
 public:
+    using TextHandle = int;
+
     TextRenderer();
     ~TextRenderer();
 
@@ -24,6 +36,13 @@ public:
     void Resize(GLint w, GLint h);
 
     void RenderText(const std::string& text, GLfloat x, GLfloat y, GLfloat scale, glm::vec3 color);
+    void Flush();
+
+    TextHandle CreateText();
+    void SetText(TextHandle handle, const std::string& text, GLfloat x, GLfloat y, GLfloat scale,
+                 glm::vec3 color);
+    void RenderText(TextHandle handle);
+
     float TextWidth(const std::string& text, GLfloat scale);
 
     inline void SetOriginBottom(bool state);
@@ -32,7 +51,27 @@ public:
     inline glm::vec2 WindowSize();
 
 private:
+    struct TextVertex
+    {
+        float vertex[4]; // pos.xy, tex.xy
+        float color[3];
+    };
+
+    struct TextLabel
+    {
+        std::string text;
+        glm::vec3 layout; // x, y, scale
+        glm::vec3 color;
+        GLuint vao;
+        GLuint vbo;
+        GLsizei count;
+    };
+
     void InitRenderData();
+    void CreateVertexArray(GLuint& vao, GLuint& vbo);
+    void AppendQuads(const std::string& text, GLfloat x, GLfloat y, GLfloat scale,
+                     glm::vec3 color, std::vector<TextVertex>& vertices);
+    void BindDrawState();
 
 private:
     glm::vec2 window_size_;
@@ -41,9 +80,14 @@ private:
     std::unique_ptr<AbstractShader> shader_;
     GLuint vao_;
     GLuint vbo_;
+    GLuint atlas_texture_;
+    std::vector<TextVertex> vertices_;
+    std::vector<TextLabel> labels_;
 
     bool is_origin_bottom_;
     GLuint font_height_;
+
+    std::shared_ptr<GlStateCache> gl_state_;
 };
 
 inline void TextRenderer::SetOriginBottom(bool state)
@@ -0,0 +1,200 @@
+#include "texture_atlas.h"
+
+#include <QPainter>
+#include <algorithm>
+#include <iostream>
+
+#include "cooked_texture.h"
+
+TextureAtlas::TextureAtlas(int page_size, int max_sprite_size, int padding)
+    : page_size_(page_size)
+    , max_sprite_size_(std::min(max_sprite_size, page_size - 2 * padding))
+    , padding_(padding)
+    , used_pixels_(0)
+    , page_pixels_(0)
+{}
+
+void TextureAtlas::Add(const std::string& name, const QImage& image)
+{
+    if (image.isNull()) {
+        std::cout << "Atlas image is null. name: " << name << std::endl;
+        return;
+    }
+
+    QImage sprite = image;
+    if (sprite.width() > max_sprite_size_ || sprite.height() > max_sprite_size_) {
+        sprite = sprite.scaled(max_sprite_size_, max_sprite_size_, Qt::KeepAspectRatio,
+                               Qt::SmoothTransformation);
+    }
+
+    pending_.push_back({name, sprite.convertToFormat(QImage::Format_RGBA8888_Premultiplied)});
+}
+
+void TextureAtlas::Pack(std::vector<QImage>& pages, std::vector<AtlasSprite>& sprites)
+{
+    // Tallest first keeps the shelves tight.
+    std::stable_sort(pending_.begin(), pending_.end(),
+                     [](const PendingImage& a, const PendingImage& b) {
+                         return a.image.height() > b.image.height();
+                     });
+
+    std::vector<PageLayout> layouts;
+
+    for (auto& pending : pending_) {
+        QRect rect;
+        size_t page = 0;
+        for (; page < layouts.size(); ++page) {
+            if (Place(layouts[page], pending.image, rect))
+                break;
+        }
+
+        if (page == layouts.size()) {
+            PageLayout layout;
+            layout.image = QImage(page_size_, page_size_, QImage::Format_RGBA8888_Premultiplied);
+            layout.image.fill(Qt::transparent);
+            layouts.emplace_back(layout);
+
+            Place(layouts.back(), pending.image, rect);
+        }
+
+        Blit(layouts[page].image, pending.image, rect);
+        sprites.push_back({pending.name, (int)page, rect});
+    }
+    pending_.clear();
+
+    // Crop the pages to the used height.
+    for (auto& layout : layouts) {
+        int used_h = std::min(page_size_, layout.shelf_y + layout.shelf_h);
+        pages.emplace_back(layout.image.copy(QRect(0, 0, page_size_, used_h)));
+    }
+}
+
+std::vector<QByteArray> TextureAtlas::Cook()
+{
+    std::vector<QImage> pages;
+    std::vector<AtlasSprite> sprites;
+    Pack(pages, sprites);
+
+    std::vector<QByteArray> blobs;
+    for (size_t page = 0; page < pages.size(); ++page) {
+        std::vector<AtlasSprite> page_sprites;
+        for (auto& sprite : sprites) {
+            if (sprite.page == (int)page) {
+                page_sprites.emplace_back(sprite);
+            }
+        }
+
+        blobs.emplace_back(CookedTexture::Cook(pages[page], kMaxMipLevel, page_sprites));
+    }
+
+    return blobs;
+}
+
+void TextureAtlas::PrintStats()
+{
+    std::cout << "Texture atlas: " << regions_.size() << " sprites, " << PageCount()
+              << " pages, occupancy " << (int)(Occupancy() * 100.0f) << "%, "
+              << MemoryBytes() / 1024 << " KB" << std::endl;
+}
+
+void TextureAtlas::AddPage(std::shared_ptr<QOpenGLTexture> texture,
+                           const std::vector<AtlasSprite>& sprites)
+{
+    if (!texture)
+        return;
+
+    pages_.emplace_back(texture);
+    page_pixels_ += (qint64)texture->width() * texture->height();
+
+    float w = (float)texture->width();
+    float h = (float)texture->height();
+    for (auto& sprite : sprites) {
+        TextureRegion region;
+        region.texture = texture;
+        region.tex_rect = QVector4D(sprite.rect.left() / w, sprite.rect.top() / h,
+                                    (sprite.rect.left() + sprite.rect.width()) / w,
+                                    (sprite.rect.top() + sprite.rect.height()) / h);
+        regions_[sprite.name] = region;
+        used_pixels_ += (qint64)sprite.rect.width() * sprite.rect.height();
+    }
+}
+
+TextureRegion TextureAtlas::Region(const std::string& name)
+{
+    auto iter = regions_.find(name);
+    if (iter == regions_.end()) {
+        std::cout << "Atlas region not found. name: " << name << std::endl;
+        return TextureRegion();
+    }
+
+    return iter->second;
+}
+
+float TextureAtlas::Occupancy()
+{
+    if (page_pixels_ == 0)
+        return 0.0f;
+
+    return (float)used_pixels_ / page_pixels_;
+}
+
+qint64 TextureAtlas::MemoryBytes()
+{
+    // RGBA8 plus the mip chain.
+    qint64 bytes = 0;
+    for (auto& page : pages_) {
+        qint64 level_bytes = (qint64)page->width() * page->height() * 4;
+        for (int level = 0; level <= kMaxMipLevel; ++level) {
+            bytes += level_bytes;
+            level_bytes /= 4;
+        }
+    }
+
+    return bytes;
+}
+
+bool TextureAtlas::Place(PageLayout& page, const QImage& image, QRect& rect)
+{
+    int w = image.width() + 2 * padding_;
+    int h = image.height() + 2 * padding_;
+
+    if (page.cursor_x + w > page_size_) {
+        // new shelf
+        page.shelf_y += page.shelf_h;
+        page.shelf_h = 0;
+        page.cursor_x = 0;
+    }
+
+    if (page.shelf_y + h > page_size_ || w > page_size_)
+        return false;
+
+    rect = QRect(page.cursor_x + padding_, page.shelf_y + padding_, image.width(), image.height());
+    page.cursor_x += w;
+    page.shelf_h = std::max(page.shelf_h, h);
+
+    return true;
+}
+
+void TextureAtlas::Blit(QImage& page, const QImage& image, const QRect& rect)
+{
+    int x = rect.left();
+    int y = rect.top();
+    int w = rect.width();
+    int h = rect.height();
+    int p = padding_;
+
+    QPainter painter(&page);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.drawImage(x, y, image);
+
+    // Extrude the border pixels into the padding so linear filtering does not bleed.
+    painter.drawImage(QRect(x - p, y, p, h), image, QRect(0, 0, 1, h));
+    painter.drawImage(QRect(x + w, y, p, h), image, QRect(w - 1, 0, 1, h));
+    painter.drawImage(QRect(x, y - p, w, p), image, QRect(0, 0, w, 1));
+    painter.drawImage(QRect(x, y + h, w, p), image, QRect(0, h - 1, w, 1));
+
+    painter.drawImage(QRect(x - p, y - p, p, p), image, QRect(0, 0, 1, 1));
+    painter.drawImage(QRect(x + w, y - p, p, p), image, QRect(w - 1, 0, 1, 1));
+    painter.drawImage(QRect(x - p, y + h, p, p), image, QRect(0, h - 1, 1, 1));
+    painter.drawImage(QRect(x + w, y + h, p, p), image, QRect(w - 1, h - 1, 1, 1));
+}
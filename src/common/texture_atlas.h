@@ -0,0 +1,110 @@
+#ifndef TEXTURE_ATLAS_H_
+#define TEXTURE_ATLAS_H_
+
+#include <QByteArray>
+#include <QImage>
+#include <QOpenGLTexture>
+#include <QVector4D>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Sub-rectangle of a texture, cheap to copy.
+ */
+struct TextureRegion
+{
+    std::shared_ptr<QOpenGLTexture> texture;
+    QVector4D tex_rect = QVector4D(0.0f, 0.0f, 1.0f, 1.0f); // u0, v0, u1, v1
+};
+
+/**
+ * @brief Placement of a packed image, in pixels of its page.
+ */
+struct AtlasSprite
+{
+    std::string name;
+    int page;
+    QRect rect;
+};
+
+/**
+ * @brief Packs many small images into a few large textures (pages) so sprites can share one
+ * texture bind.
+ */
+class TextureAtlas
+{
+public:
+    // Mip levels are limited so that the padding still separates the sprites on every level.
+    static constexpr int kMaxMipLevel = 2;
+
+    TextureAtlas(int page_size = 1024, int max_sprite_size = 256, int padding = 4);
+    ~TextureAtlas() = default;
+
+    /**
+     * @brief Queue an image for packing. Images larger than max_sprite_size are scaled down.
+     */
+    void Add(const std::string& name, const QImage& image);
+
+    /**
+     * @brief Pack the queued images into page images, without touching GL. The images are
+     * premultiplied.
+     */
+    void Pack(std::vector<QImage>& pages, std::vector<AtlasSprite>& sprites);
+
+    /**
+     * @brief Pack the queued images and cook every page with its sprite table, see
+     * CookedTexture. Does not touch GL.
+     */
+    std::vector<QByteArray> Cook();
+
+    /**
+     * @brief Add an uploaded page, e.g. a cooked one, with the sprites placed on it.
+     */
+    void AddPage(std::shared_ptr<QOpenGLTexture> texture, const std::vector<AtlasSprite>& sprites);
+
+    TextureRegion Region(const std::string& name);
+
+    inline int PageCount();
+    float Occupancy();
+    qint64 MemoryBytes();
+    void PrintStats();
+
+private:
+    struct PendingImage
+    {
+        std::string name;
+        QImage image;
+    };
+
+    struct PageLayout
+    {
+        QImage image;
+        int shelf_y = 0;
+        int shelf_h = 0;
+        int cursor_x = 0;
+    };
+
+    bool Place(PageLayout& page, const QImage& image, QRect& rect);
+    void Blit(QImage& page, const QImage& image, const QRect& rect);
+
+private:
+    int page_size_;
+    int max_sprite_size_;
+    int padding_;
+
+    std::vector<PendingImage> pending_;
+    std::vector<std::shared_ptr<QOpenGLTexture>> pages_;
+    std::unordered_map<std::string, TextureRegion> regions_;
+
+    qint64 used_pixels_;
+    qint64 page_pixels_;
+};
+
+inline int TextureAtlas::PageCount()
+{
+    return (int)pages_.size();
+}
+
+#endif
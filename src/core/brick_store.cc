@@ -0,0 +1,139 @@
+#include "brick_store.h"
+
+#include <algorithm>
+
+#if defined(BREAKOUT_AVX2)
+#include <immintrin.h>
+#define BRICK_STORE_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BRICK_STORE_SSE2
+#endif
+
+void BrickStore::Clear()
+{
+    x_.clear();
+    y_.clear();
+    w_.clear();
+    h_.clear();
+    style_.clear();
+    alive_.clear();
+}
+
+void BrickStore::Reserve(int count)
+{
+    x_.reserve(count);
+    y_.reserve(count);
+    w_.reserve(count);
+    h_.reserve(count);
+    style_.reserve(count);
+    alive_.reserve((count + 31) / 32);
+}
+
+int BrickStore::Add(float x, float y, float w, float h, uint8_t style)
+{
+    int index = Size();
+    x_.push_back(x);
+    y_.push_back(y);
+    w_.push_back(w);
+    h_.push_back(h);
+    style_.push_back(style);
+
+    if ((index & 31) == 0) {
+        alive_.push_back(0);
+    }
+    alive_[index >> 5] |= 1u << (index & 31);
+
+    return index;
+}
+
+void BrickStore::Kill(int index)
+{
+    alive_[index >> 5] &= ~(1u << (index & 31));
+}
+
+void BrickStore::OverlapCircleScalar(int begin, int end, float cx, float cy, float radius,
+                                     std::vector<int>& hits) const
+{
+    float radius_sq = radius * radius;
+    for (int i = begin; i < end; ++i) {
+        // distance from the center to the box along each axis, 0 inside
+        float dx = std::max(std::max(x_[i] - cx, cx - x_[i] - w_[i]), 0.0f);
+        float dy = std::max(std::max(y_[i] - cy, cy - y_[i] - h_[i]), 0.0f);
+        if (dx * dx + dy * dy <= radius_sq && IsAlive(i)) {
+            hits.push_back(i);
+        }
+    }
+}
+
+void BrickStore::OverlapCircle(int begin, int end, float cx, float cy, float radius,
+                               std::vector<int>& hits) const
+{
+    int i = begin;
+
+#if defined(BRICK_STORE_AVX2)
+    const __m256 center_x = _mm256_set1_ps(cx);
+    const __m256 center_y = _mm256_set1_ps(cy);
+    const __m256 radius_sq = _mm256_set1_ps(radius * radius);
+    const __m256 zero = _mm256_setzero_ps();
+    for (; i + 8 <= end; i += 8) {
+        __m256 x = _mm256_loadu_ps(&x_[i]);
+        __m256 y = _mm256_loadu_ps(&y_[i]);
+        __m256 w = _mm256_loadu_ps(&w_[i]);
+        __m256 h = _mm256_loadu_ps(&h_[i]);
+
+        __m256 dx = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(x, center_x),
+                                                _mm256_sub_ps(_mm256_sub_ps(center_x, x), w)),
+                                  zero);
+        __m256 dy = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(y, center_y),
+                                                _mm256_sub_ps(_mm256_sub_ps(center_y, y), h)),
+                                  zero);
+        __m256 dist_sq = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+
+        int mask = _mm256_movemask_ps(_mm256_cmp_ps(dist_sq, radius_sq, _CMP_LE_OQ));
+        for (int lane = 0; mask; ++lane, mask >>= 1) {
+            if ((mask & 1) && IsAlive(i + lane)) {
+                hits.push_back(i + lane);
+            }
+        }
+    }
+#elif defined(BRICK_STORE_SSE2)
+    const __m128 center_x = _mm_set1_ps(cx);
+    const __m128 center_y = _mm_set1_ps(cy);
+    const __m128 radius_sq = _mm_set1_ps(radius * radius);
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= end; i += 4) {
+        __m128 x = _mm_loadu_ps(&x_[i]);
+        __m128 y = _mm_loadu_ps(&y_[i]);
+        __m128 w = _mm_loadu_ps(&w_[i]);
+        __m128 h = _mm_loadu_ps(&h_[i]);
+
+        __m128 dx = _mm_max_ps(
+            _mm_max_ps(_mm_sub_ps(x, center_x), _mm_sub_ps(_mm_sub_ps(center_x, x), w)), zero);
+        __m128 dy = _mm_max_ps(
+            _mm_max_ps(_mm_sub_ps(y, center_y), _mm_sub_ps(_mm_sub_ps(center_y, y), h)), zero);
+        __m128 dist_sq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+
+        int mask = _mm_movemask_ps(_mm_cmple_ps(dist_sq, radius_sq));
+        for (int lane = 0; mask; ++lane, mask >>= 1) {
+            if ((mask & 1) && IsAlive(i + lane)) {
+                hits.push_back(i + lane);
+            }
+        }
+    }
+#endif
+
+    // the remainder, or everything without SIMD
+    OverlapCircleScalar(i, end, cx, cy, radius, hits);
+}
+
+const char* BrickStore::SimdName()
+{
+#if defined(BRICK_STORE_AVX2)
+    return "avx2";
+#elif defined(BRICK_STORE_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
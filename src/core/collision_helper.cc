@@ -0,0 +1,161 @@
+#include "collision_helper.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static const CollisionHelper::SweepResult kMiss = {false, 1.0f, glm::vec2(0.0f, 0.0f)};
+
+// First time in [0, 1] at which a point moving by delta from start comes within radius of
+// corner, the rounded corners of the swept box.
+static CollisionHelper::SweepResult SweepPointCircle(const glm::vec2& start,
+                                                     const glm::vec2& delta,
+                                                     const glm::vec2& corner, float radius)
+{
+    glm::vec2 offset = start - corner;
+    float a = glm::dot(delta, delta);
+    float b = glm::dot(offset, delta);
+    float c = glm::dot(offset, offset) - radius * radius;
+
+    // moving away from the corner or missing it
+    float discriminant = b * b - a * c;
+    if (a <= 0.0f || b >= 0.0f || discriminant < 0.0f)
+        return kMiss;
+
+    float time = std::max(0.0f, (-b - std::sqrt(discriminant)) / a);
+    if (time > 1.0f)
+        return kMiss;
+
+    return {true, time, glm::normalize(offset + delta * time)};
+}
+
+CollisionHelper::CollisionHelper() {}
+
+bool CollisionHelper::CheckCollision(GameObject* one, GameObject* two)
+{
+    bool is_x_axis_align = one->Pos().x + one->Size().x >= two->Pos().x
+                           && two->Pos().x + two->Size().x >= one->Pos().x;
+
+    bool is_y_axis_align = one->Pos().y + one->Size().y >= two->Pos().y
+                           && two->Pos().y + two->Size().y >= one->Pos().y;
+
+    return is_x_axis_align && is_y_axis_align;
+}
+
+CollisionHelper::SweepResult CollisionHelper::SweepCircleBox(const glm::vec2& center, float radius,
+                                                             const glm::vec2& delta,
+                                                             const glm::vec2& box_pos,
+                                                             const glm::vec2& box_size)
+{
+    glm::vec2 box_min = box_pos;
+    glm::vec2 box_max = box_pos + box_size;
+
+    // Already touching: hit now if moving deeper, otherwise let the circle leave.
+    glm::vec2 outward = center - glm::clamp(center, box_min, box_max);
+    if (glm::dot(outward, outward) <= radius * radius) {
+        if (outward == glm::vec2(0.0f, 0.0f)) {
+            // center inside the box, push out along the shortest axis
+            float left = center.x - box_min.x;
+            float right = box_max.x - center.x;
+            float top = center.y - box_min.y;
+            float bottom = box_max.y - center.y;
+            float min_x = std::min(left, right);
+            float min_y = std::min(top, bottom);
+            if (min_x < min_y) {
+                outward = glm::vec2(left < right ? -1.0f : 1.0f, 0.0f);
+            } else {
+                outward = glm::vec2(0.0f, top < bottom ? -1.0f : 1.0f);
+            }
+        }
+
+        glm::vec2 normal = glm::normalize(outward);
+        if (glm::dot(delta, normal) < 0.0f)
+            return {true, 0.0f, normal};
+
+        return kMiss;
+    }
+
+    // The center against the box grown by the radius (slabs), the corners are rounded below.
+    const float kInfinity = std::numeric_limits<float>::infinity();
+    float t_enter = -kInfinity;
+    float t_exit = kInfinity;
+    int enter_axis = 0;
+    for (int axis = 0; axis < 2; ++axis) {
+        float lo = box_min[axis] - radius;
+        float hi = box_max[axis] + radius;
+        if (delta[axis] == 0.0f) {
+            if (center[axis] < lo || center[axis] > hi)
+                return kMiss;
+            continue;
+        }
+
+        float t0 = (lo - center[axis]) / delta[axis];
+        float t1 = (hi - center[axis]) / delta[axis];
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+        if (t0 > t_enter) {
+            t_enter = t0;
+            enter_axis = axis;
+        }
+        t_exit = std::min(t_exit, t1);
+    }
+
+    if (t_enter > t_exit || t_enter > 1.0f || t_exit < 0.0f)
+        return kMiss;
+
+    // Entering through a face: the other coordinate is within the box.
+    glm::vec2 contact = center + delta * std::max(t_enter, 0.0f);
+    int other_axis = 1 - enter_axis;
+    if (t_enter >= 0.0f && contact[other_axis] >= box_min[other_axis] &&
+        contact[other_axis] <= box_max[other_axis]) {
+        glm::vec2 normal(0.0f, 0.0f);
+        normal[enter_axis] = delta[enter_axis] > 0.0f ? -1.0f : 1.0f;
+        return {true, t_enter, normal};
+    }
+
+    // Otherwise through a corner square, the contact is on the corner circle or nowhere.
+    glm::vec2 corner(contact.x < box_min.x ? box_min.x : box_max.x,
+                     contact.y < box_min.y ? box_min.y : box_max.y);
+    return SweepPointCircle(center, delta, corner, radius);
+}
+
+CollisionHelper::SweepResult CollisionHelper::SweepCircleBorders(const glm::vec2& center,
+                                                                 float radius,
+                                                                 const glm::vec2& delta, float w)
+{
+    SweepResult result = kMiss;
+
+    // A circle already past a border hits it at once when it keeps moving outwards.
+    if (delta.x < 0.0f) {
+        float time = std::max(0.0f, (radius - center.x) / delta.x);
+        if (time <= 1.0f) {
+            result = {true, time, glm::vec2(1.0f, 0.0f)};
+        }
+    } else if (delta.x > 0.0f) {
+        float time = std::max(0.0f, (w - radius - center.x) / delta.x);
+        if (time <= 1.0f) {
+            result = {true, time, glm::vec2(-1.0f, 0.0f)};
+        }
+    }
+
+    if (delta.y < 0.0f) {
+        float time = std::max(0.0f, (radius - center.y) / delta.y);
+        SweepResult top = {true, time, glm::vec2(0.0f, 1.0f)};
+        if (time <= 1.0f && IsEarlier(top, result)) {
+            result = top;
+        }
+    }
+
+    return result;
+}
+
+glm::vec2 CollisionHelper::Reflect(const glm::vec2& velocity, const glm::vec2& normal)
+{
+    return velocity - 2.0f * glm::dot(velocity, normal) * normal;
+}
+
+bool CollisionHelper::IsEarlier(const SweepResult& a, const SweepResult& b)
+{
+    return a.hit && (!b.hit || a.time < b.time);
+}
@@ -0,0 +1,53 @@
+#ifndef COLLISION_HELPER_H_
+#define COLLISION_HELPER_H_
+
+#include "game_object.h"
+
+class CollisionHelper
+{
+public:
+    CollisionHelper();
+
+    /**
+     * @brief First contact of a moving circle, as a fraction of its motion.
+     */
+    struct SweepResult
+    {
+        bool hit;
+        float time;       // in [0, 1]
+        glm::vec2 normal; // surface normal at the contact, pointing towards the circle
+    };
+
+    /**
+     * @brief Check collision between AABB.
+     */
+    static bool CheckCollision(GameObject* one, GameObject* two);
+
+    /**
+     * @brief Swept circle against an AABB: the circle at center moves by delta. A circle that
+     * already touches the box hits at time 0 when it moves deeper and misses when it moves out,
+     * so a resolved contact is not hit again.
+     */
+    static SweepResult SweepCircleBox(const glm::vec2& center, float radius,
+                                      const glm::vec2& delta, const glm::vec2& box_pos,
+                                      const glm::vec2& box_size);
+
+    /**
+     * @brief Swept circle against the left, top and right border of an area w wide. The bottom
+     * is open.
+     */
+    static SweepResult SweepCircleBorders(const glm::vec2& center, float radius,
+                                          const glm::vec2& delta, float w);
+
+    /**
+     * @brief Mirror a velocity on the surface with the given unit normal.
+     */
+    static glm::vec2 Reflect(const glm::vec2& velocity, const glm::vec2& normal);
+
+    /**
+     * @brief The earlier of two sweeps, a on ties.
+     */
+    static bool IsEarlier(const SweepResult& a, const SweepResult& b);
+};
+
+#endif
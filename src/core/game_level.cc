@@ -0,0 +1,192 @@
+#include "game_level.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+GameLevel::GameLevel(int w, int h)
+    : w_(w)
+    , h_(h)
+    , level_num_(1)
+    , level_(0)
+    , revision_(0)
+    , layout_revision_(0)
+    , remaining_(0)
+    , grid_cols_(0)
+    , grid_rows_(0)
+    , cell_size_(0.0f, 0.0f)
+{}
+
+GameLevel::~GameLevel() {}
+
+void GameLevel::Resize(int w, int h)
+{
+    w_ = w;
+    h_ = h;
+
+    if (level_datas_.empty()) {
+        Load(0);
+        BuildBricks(level_datas_);
+    } else {
+        BuildBricks(level_datas_); // TODO Only the size and position are refreshed.
+    }
+}
+
+void GameLevel::Load(const char* filename)
+{
+    level_datas_ = ReadLayersFromFile(filename);
+    BuildBricks(level_datas_);
+}
+
+void GameLevel::Load(int level)
+{
+    std::stringstream level_str;
+    level_str << (level + 1);
+
+    std::string file = "res/levels/level_" + level_str.str() + ".lvl";
+    Load(file.c_str());
+}
+
+GameLevel::BrickHit GameLevel::SweepBricks(const glm::vec2& center, float radius,
+                                           const glm::vec2& delta)
+{
+    BrickHit first = {-1, {false, 1.0f, glm::vec2(0.0f, 0.0f)}};
+    if (cell_first_.empty() || cell_size_.x <= 0.0f || cell_size_.y <= 0.0f)
+        return first;
+
+    // grid cells under the bounds of the whole motion
+    glm::vec2 end = center + delta;
+    float left = std::min(center.x, end.x) - radius;
+    float top = std::min(center.y, end.y) - radius;
+    float right = std::max(center.x, end.x) + radius;
+    float bottom = std::max(center.y, end.y) + radius;
+
+    int col_begin = std::max(0, (int)std::floor(left / cell_size_.x));
+    int col_end = std::min(grid_cols_ - 1, (int)std::floor(right / cell_size_.x));
+    int row_begin = std::max(0, (int)std::floor(top / cell_size_.y));
+    int row_end = std::min(grid_rows_ - 1, (int)std::floor(bottom / cell_size_.y));
+    if (col_begin > col_end)
+        return first;
+
+    // Every brick the ball touches on its way overlaps this circle.
+    glm::vec2 mid = center + delta * 0.5f;
+    float reach = radius + glm::length(delta) * 0.5f;
+
+    candidates_.clear();
+    for (int row = row_begin; row <= row_end; ++row) {
+        int first_brick = cell_first_[row * grid_cols_ + col_begin];
+        int last_brick = cell_first_[row * grid_cols_ + col_end + 1];
+        bricks_.OverlapCircle(first_brick, last_brick, mid.x, mid.y, reach, candidates_);
+    }
+
+    // In index order like a full scan, so ties go to the brick it would find first.
+    for (int index : candidates_) {
+        auto sweep = CollisionHelper::SweepCircleBox(
+            center, radius, delta, glm::vec2(bricks_.X(index), bricks_.Y(index)),
+            glm::vec2(bricks_.W(index), bricks_.H(index)));
+        if (CollisionHelper::IsEarlier(sweep, first.sweep)) {
+            first = {index, sweep};
+        }
+    }
+
+    return first;
+}
+
+bool GameLevel::HitBrick(SphereObject* sphere, const BrickHit& hit)
+{
+    bool is_solid = bricks_.Style(hit.index) == TV_HARD_BRICK;
+
+    // A pass-through ball only bounces off solid bricks.
+    if (is_solid || !sphere->IsPassThrough()) {
+        sphere->SetVelocity(CollisionHelper::Reflect(sphere->Velocity(), hit.sweep.normal));
+    }
+
+    if (is_solid)
+        return false;
+
+    bricks_.Kill(hit.index);
+    --remaining_;
+    ++revision_;
+
+    return true;
+}
+
+void GameLevel::PreviousLevel()
+{
+    if (--level_ < 0) {
+        level_ = level_num_ - 1;
+    }
+    Load(level_);
+}
+
+void GameLevel::NextLevel()
+{
+    level_ = ++level_ % level_num_;
+    Load(level_);
+}
+
+std::vector<std::vector<int>> GameLevel::ReadLayersFromFile(const char* file)
+{
+    std::ifstream ifs(file, std::ios_base::in);
+
+    std::string line;
+    std::vector<std::vector<int>> level_datas;
+    int tileData;
+
+    while (std::getline(ifs, line)) {
+        std::vector<int> line_datas;
+
+        std::istringstream iss(line);
+        while (iss >> tileData) {
+            line_datas.emplace_back(tileData);
+        }
+        level_datas.emplace_back(line_datas);
+    }
+
+    return level_datas;
+}
+
+void GameLevel::BuildBricks(const std::vector<std::vector<int>>& level_datas)
+{
+    bricks_.Clear();
+    cell_first_.clear();
+    remaining_ = 0;
+    ++revision_;
+    ++layout_revision_;
+
+    int rows = (int)level_datas.size();
+    if (rows == 0)
+        return;
+
+    int cols = (int)level_datas[0].size();
+
+    glm::vec2 size(w_ / (float)cols, (h_ >> 1) / rows);
+
+    bricks_.Reserve(rows * cols);
+    cell_first_.resize(rows * cols + 1);
+    grid_cols_ = cols;
+    grid_rows_ = rows;
+    cell_size_ = size;
+
+    glm::vec2 pos(0.0f, 0.0f);
+
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            int tile = level_datas[row][col];
+            cell_first_[row * cols + col] = bricks_.Size();
+            if (IsBrick(tile)) {
+                bricks_.Add(pos.x, pos.y, size.x, size.y, (uint8_t)tile);
+                if (tile != TV_HARD_BRICK) {
+                    ++remaining_;
+                }
+            }
+
+            pos.x += size.x;
+        }
+        pos.x = 0.0f;
+        pos.y += size.y;
+    }
+    cell_first_[rows * cols] = bricks_.Size();
+}
@@ -0,0 +1,152 @@
+#ifndef GAME_LEVEL_H_
+#define GAME_LEVEL_H_
+
+#include <vector>
+
+#include "brick_store.h"
+#include "collision_helper.h"
+#include "game_object.h"
+
+/**
+ * @brief Bricks of the current level and the ball's collision with them. Drawing them is left
+ * to the renderer, which follows Revision() and LayoutRevision().
+ */
+class GameLevel
+{
+public:
+    enum TileValue
+    {
+        TV_NON_BRICK,
+        TV_HARD_BRICK,
+        TV_STYLE_1_BRICK,
+        TV_STYLE_2_BRICK,
+        TV_STYLE_3_BRICK,
+        TV_STYLE_4_BRICK,
+        TV_STYLE_5_BRICK,
+        TV_COUNT
+    };
+
+    struct BrickHit
+    {
+        int index; // -1 if no brick is hit
+        CollisionHelper::SweepResult sweep;
+    };
+
+    GameLevel(int w, int h);
+    ~GameLevel();
+
+    void Resize(int w, int h);
+    void Load(const char* filename);
+    void Load(int level);
+
+    /**
+     * @brief First brick a ball centered at center hits while moving by delta. Only the bricks in
+     * the grid cells under the motion are tested, the cost does not grow with the level size.
+     * They are culled in batches against a circle around the motion before the exact sweep.
+     */
+    BrickHit SweepBricks(const glm::vec2& center, float radius, const glm::vec2& delta);
+
+    /**
+     * @brief Bounce the ball off the brick found by SweepBricks(), breakable bricks are destroyed.
+     * @return True if the brick was destroyed.
+     */
+    bool HitBrick(SphereObject* sphere, const BrickHit& hit);
+
+    inline void SetLevelNum(int num);
+    inline int Level() const;
+
+    /**
+     * @brief Bumped whenever the drawn bricks change, a load, a resize or a destroyed brick.
+     */
+    inline int Revision() const;
+
+    /**
+     * @brief Bumped when the bricks are rebuilt, a load or a resize. Bricks keep their index in
+     * between and are laid out like Tiles(), row-major over the tiles that are bricks.
+     */
+    inline int LayoutRevision() const;
+
+    inline const std::vector<std::vector<int>>& Tiles() const;
+    inline const BrickStore& Bricks() const;
+    inline glm::vec2 CellSize() const;
+
+    static inline bool IsBrick(int tile);
+
+    inline bool IsCompleted() const;
+
+    void PreviousLevel();
+    void NextLevel();
+
+private:
+    std::vector<std::vector<int>> ReadLayersFromFile(const char* file);
+    void BuildBricks(const std::vector<std::vector<int>>& level_datas);
+
+private:
+    int w_;
+    int h_;
+
+    int level_num_;
+    int level_;
+    int revision_;
+    int layout_revision_;
+
+    std::vector<std::vector<int>> level_datas_;
+    BrickStore bricks_;
+    int remaining_; // breakable bricks not destroyed yet
+
+    // Broadphase. Bricks are stored row-major, so the bricks of the cells [col_begin, col_end]
+    // of a row are the range [cell_first_[first cell], cell_first_[last cell + 1]) of bricks_.
+    std::vector<int> cell_first_;
+    std::vector<int> candidates_;
+    int grid_cols_;
+    int grid_rows_;
+    glm::vec2 cell_size_;
+};
+
+
+inline void GameLevel::SetLevelNum(int num)
+{
+    level_num_ = num;
+}
+
+inline int GameLevel::Level() const
+{
+    return level_;
+}
+
+inline int GameLevel::Revision() const
+{
+    return revision_;
+}
+
+inline int GameLevel::LayoutRevision() const
+{
+    return layout_revision_;
+}
+
+inline const std::vector<std::vector<int>>& GameLevel::Tiles() const
+{
+    return level_datas_;
+}
+
+inline const BrickStore& GameLevel::Bricks() const
+{
+    return bricks_;
+}
+
+inline glm::vec2 GameLevel::CellSize() const
+{
+    return cell_size_;
+}
+
+inline bool GameLevel::IsBrick(int tile)
+{
+    return tile > TV_NON_BRICK && tile < TV_COUNT;
+}
+
+inline bool GameLevel::IsCompleted() const
+{
+    return remaining_ == 0;
+}
+
+#endif
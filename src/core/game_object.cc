@@ -0,0 +1,126 @@
+#include "game_object.h"
+
+static const glm::vec2 kInitSphereVelocity(100.0f, -350.0f);
+
+GameObject::GameObject()
+    : GameObject(glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 1.0f))
+{}
+
+GameObject::GameObject(const glm::vec2& pos, const glm::vec2& size)
+    : pos_(pos)
+    , prev_pos_(pos)
+    , size_(size)
+{}
+
+GameObject::~GameObject() {}
+
+void GameObject::SetPos(const glm::vec2& pos)
+{
+    pos_ = pos;
+}
+
+glm::vec2 GameObject::Pos() const
+{
+    return pos_;
+}
+
+void GameObject::StorePrevPos()
+{
+    prev_pos_ = pos_;
+}
+
+glm::vec2 GameObject::PrevPos() const
+{
+    return prev_pos_;
+}
+
+void GameObject::SetSize(const glm::vec2& size)
+{
+    size_ = size;
+}
+
+glm::vec2 GameObject::Size() const
+{
+    return size_;
+}
+
+void GameObject::Reset(const glm::vec2& pos)
+{
+    SetPos(pos);
+    StorePrevPos();
+}
+
+SphereObject::SphereObject(const glm::vec2& pos, float radius)
+    : GameObject(pos, glm::vec2(2 * radius, 2 * radius))
+    , is_stuck_(true)
+    , is_sticky_(false)
+    , is_pass_through_(false)
+    , radius_(radius)
+    , default_velocity_(kInitSphereVelocity)
+    , velocity_(kInitSphereVelocity)
+{}
+
+void SphereObject::SetRadius(float radius)
+{
+    radius_ = radius;
+    size_ = glm::vec2(2 * radius, 2 * radius);
+}
+
+float SphereObject::Radius() const
+{
+    return radius_;
+}
+
+void SphereObject::SetVelocity(const glm::vec2& velocity)
+{
+    velocity_ = velocity;
+}
+
+glm::vec2 SphereObject::Velocity() const
+{
+    return velocity_;
+}
+
+glm::vec2 SphereObject::DefaultVelocity() const
+{
+    return default_velocity_;
+}
+
+void SphereObject::SetSticky(bool state)
+{
+    is_sticky_ = state;
+}
+
+bool SphereObject::IsSticky() const
+{
+    return is_sticky_;
+}
+
+void SphereObject::SetPassThrough(bool state)
+{
+    is_pass_through_ = state;
+}
+
+bool SphereObject::IsPassThrough() const
+{
+    return is_pass_through_;
+}
+
+void SphereObject::Reset(const glm::vec2& pos)
+{
+    GameObject::SetPos(pos);
+    StorePrevPos();
+
+    is_stuck_ = true;
+    velocity_ = default_velocity_;
+}
+
+void SphereObject::SetStuck(bool state)
+{
+    is_stuck_ = state;
+}
+
+bool SphereObject::IsStuck() const
+{
+    return is_stuck_;
+}
@@ -0,0 +1,69 @@
+#ifndef GAME_OBJECT_H_
+#define GAME_OBJECT_H_
+
+#include "glm.hpp"
+
+/**
+ * @brief Simulated box, in pixels. Drawing is left to the renderer, which interpolates between
+ * PrevPos() and Pos().
+ */
+class GameObject
+{
+public:
+    GameObject();
+    GameObject(const glm::vec2& pos, const glm::vec2& size);
+    virtual ~GameObject();
+
+    void SetPos(const glm::vec2& pos);
+    glm::vec2 Pos() const;
+
+    /**
+     * @brief Remember the position at the start of a simulation step for render interpolation.
+     */
+    void StorePrevPos();
+    glm::vec2 PrevPos() const;
+
+    void SetSize(const glm::vec2& size);
+    glm::vec2 Size() const;
+
+    virtual void Reset(const glm::vec2& pos);
+
+protected:
+    glm::vec2 pos_;
+    glm::vec2 prev_pos_;
+    glm::vec2 size_;
+};
+
+class SphereObject : public GameObject
+{
+public:
+    SphereObject(const glm::vec2& pos, float radius);
+    ~SphereObject() {}
+
+    void SetStuck(bool state);
+    bool IsStuck() const;
+
+    void SetRadius(float radius);
+    float Radius() const;
+
+    void SetVelocity(const glm::vec2& velocity);
+    glm::vec2 Velocity() const;
+    glm::vec2 DefaultVelocity() const;
+
+    void SetSticky(bool state);
+    bool IsSticky() const;
+
+    void SetPassThrough(bool state);
+    bool IsPassThrough() const;
+
+    void Reset(const glm::vec2& pos) override;
+
+private:
+    bool is_stuck_;
+    bool is_sticky_;
+    bool is_pass_through_;
+    float radius_;
+    glm::vec2 default_velocity_;
+    glm::vec2 velocity_;
+};
+#endif
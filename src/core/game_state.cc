@@ -0,0 +1,6 @@
+#include "game_state.h"
+
+GameState::GameState()
+    : state_(SF_MENU)
+    , lives_(3)
+{}
@@ -1,8 +1,6 @@
 #ifndef GAME_STATE_H_
 #define GAME_STATE_H_
 
-#include "text_renderer.h"
-
 class GameState
 {
 public:
@@ -16,13 +14,11 @@ public:
     GameState();
     ~GameState() {}
 
-    void Draw(std::shared_ptr<TextRenderer> renderer);
-
     inline void SetState(StateFlag state);
-    inline StateFlag State();
+    inline StateFlag State() const;
 
     inline void SetLives(int lives);
-    inline int Lives();
+    inline int Lives() const;
 
 private:
     StateFlag state_;
@@ -34,7 +30,7 @@ inline void GameState::SetState(StateFlag state)
     state_ = state;
 }
 
-inline GameState::StateFlag GameState::State()
+inline GameState::StateFlag GameState::State() const
 {
     return state_;
 }
@@ -47,7 +43,7 @@ inline void GameState::SetLives(int lives)
     lives_ = lives;
 }
 
-inline int GameState::Lives()
+inline int GameState::Lives() const
 {
     return lives_;
 }
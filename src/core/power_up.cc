@@ -0,0 +1,13 @@
+#include "power_up.h"
+
+PowerUp::PowerUp(Type type, const glm::vec2& pos, const glm::vec2& size)
+    : GameObject(pos, size)
+    , type_(type)
+    , is_activated_(false)
+    , duration_ms_(5000)
+{}
+
+void PowerUp::SetActive(bool state)
+{
+    is_activated_ = state;
+}
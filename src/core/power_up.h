@@ -1,10 +1,7 @@
 #ifndef POWER_UP_H_
 #define POWER_UP_H_
 
-#include <QOpenGLTexture>
-
 #include "game_object.h"
-#include "sprite_renderer.h"
 
 class PowerUp : public GameObject
 {
@@ -16,22 +13,22 @@ public:
         T_PASS_THROUGH,
         T_PAD_SIZE_INCREASE,
         T_CONFUSE,
-        T_CHAOS
+        T_CHAOS,
+        T_MULTI_BALL
     };
 
-    PowerUp(Type type, const QVector2D& pos, const QVector2D& size, const QVector3D& color,
-            std::shared_ptr<QOpenGLTexture> texture);
+    PowerUp(Type type, const glm::vec2& pos, const glm::vec2& size);
     ~PowerUp() {}
 
-    inline Type PowerUpType();
+    inline Type PowerUpType() const;
 
     void SetDuration(int ms);
-    inline int DurationMs();
+    inline int DurationMs() const;
 
     void SetActive(bool state);
-    inline bool IsActive();
+    inline bool IsActive() const;
 
-    inline bool IsDone();
+    inline bool IsDone() const;
 
 private:
     Type type_;
@@ -39,7 +36,7 @@ private:
     int duration_ms_;
 };
 
-inline PowerUp::Type PowerUp::PowerUpType()
+inline PowerUp::Type PowerUp::PowerUpType() const
 {
     return type_;
 }
@@ -49,17 +46,17 @@ inline void PowerUp::SetDuration(int ms)
     duration_ms_ = ms;
 }
 
-inline int PowerUp::DurationMs()
+inline int PowerUp::DurationMs() const
 {
     return duration_ms_;
 }
 
-inline bool PowerUp::IsActive()
+inline bool PowerUp::IsActive() const
 {
     return is_activated_;
 }
 
-inline bool PowerUp::IsDone()
+inline bool PowerUp::IsDone() const
 {
     return duration_ms_ == 0;
 }
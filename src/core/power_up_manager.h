@@ -0,0 +1,55 @@
+#ifndef POWER_UP_MANAGER_H_
+#define POWER_UP_MANAGER_H_
+
+#include "power_up.h"
+#include "rng.h"
+
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class PowerUpManager
+{
+public:
+    typedef std::unordered_map<PowerUp::Type, std::vector<std::shared_ptr<PowerUp>>> PowerUpMap;
+
+    PowerUpManager();
+    ~PowerUpManager() {}
+
+    void SpawnPowerUp(const glm::vec2& pos, Rng& rng);
+    void Update(float dt, int h, std::function<void(PowerUp::Type)> cb);
+
+    void DoCollision(GameObject* object, std::function<void(PowerUp::Type)> cb);
+
+    void Clear();
+
+    /**
+     * @brief True when no power-up is falling or running its timer.
+     */
+    bool IsIdle() const;
+
+    /**
+     * @brief Falling and running power-ups by type, for drawing.
+     */
+    inline const PowerUpMap& PowerUps() const;
+
+private:
+    inline void TrySpawnPowerup(const glm::vec2& pos, int probability, PowerUp::Type type,
+                                Rng& rng);
+
+    inline bool IsExistSamePowerUpActived(PowerUp::Type type) const;
+
+private:
+    int probability_of_good_;
+    int probability_of_bad_;
+
+    PowerUpMap powerup_map_;
+};
+
+inline const PowerUpManager::PowerUpMap& PowerUpManager::PowerUps() const
+{
+    return powerup_map_;
+}
+
+#endif
@@ -0,0 +1,26 @@
+#include "rng.h"
+
+Rng::Rng(uint32_t seed)
+    : state_(1)
+{
+    Seed(seed);
+}
+
+void Rng::Seed(uint32_t seed)
+{
+    // xorshift never leaves the zero state
+    state_ = seed != 0 ? seed : 0x9e3779b9u;
+}
+
+uint32_t Rng::Next()
+{
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 17;
+    state_ ^= state_ << 5;
+    return state_;
+}
+
+int Rng::NextInt(int n)
+{
+    return (int)(Next() % (uint32_t)n);
+}
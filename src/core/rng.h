@@ -0,0 +1,29 @@
+#ifndef RNG_H_
+#define RNG_H_
+
+#include <cstdint>
+
+/**
+ * @brief Small deterministic generator (xorshift32) for the simulation. Unlike rand() it is
+ * owned by the game, so the same seed and inputs replay the same game on every platform.
+ */
+class Rng
+{
+public:
+    explicit Rng(uint32_t seed = 1);
+    ~Rng() = default;
+
+    void Seed(uint32_t seed);
+
+    uint32_t Next();
+
+    /**
+     * @return A value in [0, n).
+     */
+    int NextInt(int n);
+
+private:
+    uint32_t state_;
+};
+
+#endif
@@ -0,0 +1,554 @@
+#include "simulation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+
+constexpr float Simulation::kStep;
+
+constexpr int kLevelCount = 4;
+constexpr int kLives = 3;
+constexpr float kSphereRadius = 12.5f;
+static const glm::vec2 kPlayerSize(100.0f, 20.0f);
+// Contacts the ball resolves within one step, the rest of the step is dropped after that.
+constexpr int kMaxSphereHits = 8;
+// Bounds the work per step in stress mode, further splits and launches add no balls.
+constexpr int kMaxSpheres = 4096;
+// The multi-ball power-up turns two copies of every ball by these angles, in radians.
+static const std::vector<float> kSplitAngles = {-0.35f, 0.35f};
+// The balls of a stress launch leave up to this angle either side of the resting ball's way,
+// from slots this many radii apart.
+constexpr float kLaunchSpread = 1.0f;
+constexpr float kLaunchSpacing = 4.0f;
+// Stress launches of up to this many balls keep the normal ball size.
+constexpr int kFullSizeLaunchCount = 64;
+
+static glm::vec2 Rotate(const glm::vec2& v, float angle)
+{
+    float c = std::cos(angle);
+    float s = std::sin(angle);
+    return glm::vec2(v.x * c - v.y * s, v.x * s + v.y * c);
+}
+
+Simulation::Simulation(unsigned int seed)
+    : w_(0)
+    , h_(0)
+    , ticks_(0)
+    , launch_count_(1)
+    , sphere_radius_(kSphereRadius)
+    , rng_(seed)
+    , game_level_(0, 0)
+    , player_(glm::vec2(0.0f, 0.0f), kPlayerSize)
+    , spheres_(1, SphereObject(glm::vec2(0.0f, 0.0f), kSphereRadius))
+    , is_sticky_player_(false)
+    , is_confuse_(false)
+    , is_chaos_(false)
+    , sphere_grid_cols_(0)
+    , sphere_grid_rows_(0)
+    , sphere_cell_size_(0.0f)
+{
+    game_state_.SetLives(kLives);
+    game_level_.SetLevelNum(kLevelCount);
+}
+
+Simulation::~Simulation() {}
+
+void Simulation::Seed(unsigned int seed)
+{
+    rng_.Seed(seed);
+}
+
+void Simulation::Resize(int w, int h)
+{
+    w_ = w;
+    h_ = h;
+
+    game_level_.Resize(w, h);
+    PlaceObjects();
+}
+
+void Simulation::SetLaunchCount(int count)
+{
+    launch_count_ = std::max(1, std::min(count, kMaxSpheres));
+    float scale = std::sqrt((float)kFullSizeLaunchCount / launch_count_);
+    sphere_radius_ = kSphereRadius * std::min(1.0f, scale);
+
+    for (auto& sphere : spheres_) {
+        sphere.SetRadius(sphere_radius_);
+        if (sphere.IsStuck()) {
+            sphere.SetPos(RestingSpherePos());
+        }
+    }
+}
+
+void Simulation::Step(const Inputs& inputs)
+{
+    events_.clear();
+    ++ticks_;
+
+    ApplyInputs(inputs);
+
+    player_.StorePrevPos();
+    for (auto& sphere : spheres_) {
+        sphere.StorePrevPos();
+    }
+
+    for (auto& sphere : spheres_) {
+        MoveSphere(&sphere, kStep);
+    }
+    CollideSpheres();
+    DoCollision();
+
+    powerup_manager_.Update(
+        kStep, h_, std::bind(&Simulation::OnDeactivatePowerUp, this, std::placeholders::_1));
+
+    if (game_level_.IsCompleted()) {
+        ResetState(GameState::SF_WIN);
+    }
+}
+
+float Simulation::FollowBall(float max_dx, float aim) const
+{
+    const SphereObject* target = &spheres_.front();
+    float lowest = std::numeric_limits<float>::lowest();
+    for (auto& sphere : spheres_) {
+        if (!sphere.IsStuck() && sphere.Velocity().y > 0.0f && sphere.Pos().y > lowest) {
+            lowest = sphere.Pos().y;
+            target = &sphere;
+        }
+    }
+
+    float sphere_center_x = target->Pos().x + target->Radius();
+    float player_center_x = player_.Pos().x + player_.Size().x / 2;
+
+    float dx = sphere_center_x - player_center_x - player_.Size().x * aim;
+    return std::max(-max_dx, std::min(dx, max_dx));
+}
+
+bool Simulation::IsMoving() const
+{
+    bool is_ball_moving = false;
+    if (game_state_.State() == GameState::SF_ACTIVE) {
+        for (auto& sphere : spheres_) {
+            is_ball_moving = is_ball_moving || !sphere.IsStuck();
+        }
+    }
+    return is_ball_moving || !powerup_manager_.IsIdle();
+}
+
+void Simulation::ApplyInputs(const Inputs& inputs)
+{
+    // levels
+    if (game_state_.State() == GameState::SF_MENU) {
+        for (int i = 0; i < std::abs(inputs.level_step); ++i) {
+            if (inputs.level_step < 0) {
+                game_level_.PreviousLevel();
+            } else {
+                game_level_.NextLevel();
+            }
+        }
+    }
+
+    // enter
+    if (inputs.is_enter) {
+        if (game_state_.State() == GameState::SF_MENU) {
+            ResetState(GameState::SF_ACTIVE);
+        } else if (game_state_.State() == GameState::SF_WIN) {
+            ResetState(GameState::SF_MENU);
+        }
+    }
+
+    bool is_playing = game_state_.State() == GameState::SF_ACTIVE;
+
+    // space
+    if (inputs.is_launch && is_playing) {
+        LaunchSpheres();
+    }
+
+    if (inputs.player_dx != 0.0f && is_playing) {
+        MovePlayer(inputs.player_dx);
+    }
+}
+
+void Simulation::MovePlayer(float dx)
+{
+    float x = std::max(0.0f, std::min(player_.Pos().x + dx, w_ - player_.Size().x));
+    glm::vec2 move(x - player_.Pos().x, 0.0f);
+    player_.SetPos(glm::vec2(x, player_.Pos().y));
+
+    // Balls resting on the paddle keep their place on it.
+    for (auto& sphere : spheres_) {
+        if (sphere.IsStuck()) {
+            sphere.SetPos(sphere.Pos() + move);
+        }
+    }
+}
+
+void Simulation::PlaceObjects()
+{
+    player_.SetPos(glm::vec2(((float)w_ - kPlayerSize.x) / 2, (float)h_ - kPlayerSize.y));
+    player_.StorePrevPos();
+
+    for (auto& sphere : spheres_) {
+        if (sphere.IsStuck()) {
+            sphere.Reset(RestingSpherePos());
+        }
+    }
+}
+
+void Simulation::MoveSphere(SphereObject* sphere, float dt)
+{
+    float radius = sphere->Radius();
+    glm::vec2 offset(radius, radius);
+
+    // Advance to the earliest contact, respond and go on with the rest of the step, so fast
+    // balls neither tunnel nor bounce off the wrong side.
+    float time_left = 1.0f;
+    for (int hit = 0; hit < kMaxSphereHits && !sphere->IsStuck(); ++hit) {
+        glm::vec2 center = sphere->Pos() + offset;
+        glm::vec2 delta = sphere->Velocity() * dt * time_left;
+
+        auto border = CollisionHelper::SweepCircleBorders(center, radius, delta, (float)w_);
+        auto paddle = CollisionHelper::SweepCircleBox(center, radius, delta, player_.Pos(),
+                                                      player_.Size());
+        auto brick = game_level_.SweepBricks(center, radius, delta);
+
+        CollisionHelper::SweepResult first = border;
+        SphereContact contact = first.hit ? SC_BORDER : SC_NONE;
+        if (CollisionHelper::IsEarlier(paddle, first)) {
+            first = paddle;
+            contact = SC_PLAYER;
+        }
+        if (CollisionHelper::IsEarlier(brick.sweep, first)) {
+            first = brick.sweep;
+            contact = SC_BRICK;
+        }
+
+        if (contact == SC_NONE) {
+            sphere->SetPos(sphere->Pos() + delta);
+            return;
+        }
+
+        sphere->SetPos(sphere->Pos() + delta * first.time);
+        time_left *= 1.0f - first.time;
+
+        switch (contact) {
+        case SC_BORDER:
+            sphere->SetVelocity(CollisionHelper::Reflect(sphere->Velocity(), first.normal));
+            break;
+        case SC_PLAYER:
+            BounceOffPlayer(sphere);
+            break;
+        case SC_BRICK: {
+            const BrickStore& bricks = game_level_.Bricks();
+            glm::vec2 pos(bricks.X(brick.index), bricks.Y(brick.index));
+            if (game_level_.HitBrick(sphere, brick)) {
+                events_.push_back({ET_BRICK_DESTROYED, brick.index, pos});
+                powerup_manager_.SpawnPowerUp(pos, rng_);
+            } else {
+                events_.push_back({ET_SOLID_HIT, brick.index, pos});
+            }
+        } break;
+        default:
+            break;
+        }
+    }
+}
+
+void Simulation::BounceOffPlayer(SphereObject* sphere)
+{
+    float player_center_x = player_.Pos().x + player_.Size().x / 2;
+
+    float distance = sphere->Pos().x + sphere->Radius() - player_center_x;
+    float percentage = distance / (player_.Size().x / 2);
+
+    float strength = 2.0f;
+    glm::vec2 old_velocity = sphere->Velocity();
+
+    // Always upwards, also when the side of the paddle is hit.
+    glm::vec2 velocity;
+    velocity.x = sphere->DefaultVelocity().x * percentage * strength;
+    velocity.y = -std::abs(old_velocity.y);
+
+    // Keep the speed size, only change direction.
+    velocity = glm::normalize(velocity) * glm::length(old_velocity);
+    sphere->SetVelocity(velocity);
+    sphere->SetStuck(sphere->IsSticky());
+
+    events_.push_back({ET_PLAYER_HIT, -1, sphere->Pos()});
+}
+
+void Simulation::DoCollision()
+{
+    // The player collides with the powerups.
+    powerup_manager_.DoCollision(&player_, std::bind(&Simulation::OnActivatePowerUp, this,
+                                                     std::placeholders::_1));
+
+    CheckSpherePos();
+}
+
+void Simulation::CollideSpheres()
+{
+    int count = (int)spheres_.size();
+    if (count < 2 || w_ <= 0 || h_ <= 0)
+        return;
+
+    // Cells as wide as the largest ball, touching balls are in the same or in neighbouring cells.
+    float radius = 0.0f;
+    for (auto& sphere : spheres_) {
+        radius = std::max(radius, sphere.Radius());
+    }
+    sphere_cell_size_ = 2 * radius;
+    sphere_grid_cols_ = (int)(w_ / sphere_cell_size_) + 1;
+    sphere_grid_rows_ = (int)(h_ / sphere_cell_size_) + 1;
+
+    // Counting sort of the balls by cell, the balls of cell c are the range
+    // [sphere_cell_first_[c], sphere_cell_first_[c + 1]) of sphere_cell_items_.
+    sphere_cells_.resize(count);
+    sphere_cell_first_.assign(sphere_grid_cols_ * sphere_grid_rows_ + 1, 0);
+    for (int i = 0; i < count; ++i) {
+        glm::vec2 center = spheres_[i].Pos() + spheres_[i].Radius();
+        int col = std::max(0, std::min((int)(center.x / sphere_cell_size_), sphere_grid_cols_ - 1));
+        int row = std::max(0, std::min((int)(center.y / sphere_cell_size_), sphere_grid_rows_ - 1));
+        sphere_cells_[i] = row * sphere_grid_cols_ + col;
+        ++sphere_cell_first_[sphere_cells_[i] + 1];
+    }
+    for (int cell = 1; cell < (int)sphere_cell_first_.size(); ++cell) {
+        sphere_cell_first_[cell] += sphere_cell_first_[cell - 1];
+    }
+
+    // Filled through the starts, which end up one cell ahead and are shifted back after.
+    sphere_cell_items_.resize(count);
+    for (int i = 0; i < count; ++i) {
+        sphere_cell_items_[sphere_cell_first_[sphere_cells_[i]]++] = i;
+    }
+    for (int cell = (int)sphere_cell_first_.size() - 1; cell > 0; --cell) {
+        sphere_cell_first_[cell] = sphere_cell_first_[cell - 1];
+    }
+    sphere_cell_first_[0] = 0;
+
+    for (int i = 0; i < count; ++i) {
+        SphereObject& sphere = spheres_[i];
+        if (sphere.IsStuck())
+            continue;
+
+        int col = sphere_cells_[i] % sphere_grid_cols_;
+        int row = sphere_cells_[i] / sphere_grid_cols_;
+        int col_begin = std::max(0, col - 1);
+        int col_end = std::min(sphere_grid_cols_ - 1, col + 1);
+
+        for (int r = std::max(0, row - 1); r <= std::min(sphere_grid_rows_ - 1, row + 1); ++r) {
+            int first_item = sphere_cell_first_[r * sphere_grid_cols_ + col_begin];
+            int last_item = sphere_cell_first_[r * sphere_grid_cols_ + col_end + 1];
+            for (int item = first_item; item < last_item; ++item) {
+                // every pair once
+                int j = sphere_cell_items_[item];
+                if (j <= i || spheres_[j].IsStuck())
+                    continue;
+
+                SphereObject& other = spheres_[j];
+                glm::vec2 offset = other.Pos() + other.Radius() - sphere.Pos() - sphere.Radius();
+                float reach = sphere.Radius() + other.Radius();
+                float distance2 = glm::dot(offset, offset);
+                if (distance2 >= reach * reach || distance2 == 0.0f)
+                    continue;
+
+                // Only balls closing in bounce, overlapping ones that already part are left
+                // alone. The balls are not pushed apart, that could push them through a brick.
+                glm::vec2 normal = offset / std::sqrt(distance2);
+                float approach = glm::dot(sphere.Velocity() - other.Velocity(), normal);
+                if (approach <= 0.0f)
+                    continue;
+
+                // equal masses, the velocities along the normal are swapped
+                sphere.SetVelocity(sphere.Velocity() - normal * approach);
+                other.SetVelocity(other.Velocity() + normal * approach);
+            }
+        }
+    }
+}
+
+void Simulation::CheckSpherePos()
+{
+    // bottom border, lost balls leave the game and a life is lost with the last one
+    auto is_lost = [this](const SphereObject& sphere) {
+        return sphere.Pos().y + 2 * sphere.Radius() >= h_;
+    };
+    if (!std::any_of(spheres_.begin(), spheres_.end(), is_lost))
+        return;
+
+    if (!std::all_of(spheres_.begin(), spheres_.end(), is_lost)) {
+        spheres_.erase(std::remove_if(spheres_.begin(), spheres_.end(), is_lost), spheres_.end());
+        return;
+    }
+
+    spheres_.erase(spheres_.begin() + 1, spheres_.end());
+
+    player_.Reset(glm::vec2(((float)w_ - kPlayerSize.x) / 2, (float)h_ - kPlayerSize.y));
+    player_.SetSize(kPlayerSize);
+
+    spheres_.front().Reset(RestingSpherePos());
+
+    game_state_.SetLives(game_state_.Lives() - 1);
+    if (game_state_.Lives() == 0) {
+        ResetState(GameState::SF_MENU);
+    }
+}
+
+void Simulation::ResetState(GameState::StateFlag state)
+{
+    if (state == game_state_.State())
+        return;
+
+    game_state_.SetState(state);
+    game_state_.SetLives(kLives);
+    game_level_.Load(0);
+
+    is_confuse_ = false;
+    powerup_manager_.Clear();
+
+    spheres_.erase(spheres_.begin() + 1, spheres_.end());
+    SphereObject& sphere = spheres_.front();
+    sphere.SetVelocity(sphere.DefaultVelocity());
+    sphere.SetPassThrough(false);
+    sphere.SetSticky(false);
+    sphere.SetStuck(true);
+    is_sticky_player_ = false;
+
+    switch (state) {
+    case GameState::SF_MENU: {
+        is_chaos_ = false;
+
+        player_.SetSize(kPlayerSize);
+        player_.SetPos(glm::vec2(((float)w_ - kPlayerSize.x) / 2, (float)h_ - kPlayerSize.y));
+
+    } break;
+    case GameState::SF_WIN: {
+        is_chaos_ = true;
+    } break;
+    default:
+        break;
+    }
+
+    sphere.SetPos(RestingSpherePos());
+    player_.StorePrevPos();
+    sphere.StorePrevPos();
+}
+
+void Simulation::SplitSphere(int index, const std::vector<float>& angles)
+{
+    // a copy, the vector may grow under a reference
+    SphereObject source = spheres_[index];
+
+    for (float angle : angles) {
+        if ((int)spheres_.size() >= kMaxSpheres)
+            return;
+
+        SphereObject sphere = source;
+        sphere.SetVelocity(Rotate(source.Velocity(), angle));
+        sphere.SetStuck(false);
+        spheres_.push_back(sphere);
+    }
+}
+
+void Simulation::LaunchSpheres()
+{
+    // Stress mode, the ball resting after a reset leaves with a rack of others over the paddle.
+    // Started from one point the balls would overlap for seconds, every pair a contact to test.
+    if (launch_count_ > 1 && spheres_.size() == 1 && spheres_.front().IsStuck()) {
+        SphereObject source = spheres_.front();
+        float spacing = kLaunchSpacing * sphere_radius_;
+        int cols = std::max(1, std::min(launch_count_, (int)(w_ / spacing)));
+        float left = (w_ - cols * spacing) / 2 + spacing / 2 - sphere_radius_;
+
+        for (int i = 1; i < launch_count_; ++i) {
+            int col = i % cols;
+            int row = i / cols;
+
+            // fanned out from the middle of the field
+            SphereObject sphere = source;
+            sphere.Reset(glm::vec2(left + col * spacing, source.Pos().y - row * spacing));
+            sphere.SetVelocity(
+                Rotate(source.Velocity(), kLaunchSpread * ((2.0f * col + 1.0f) / cols - 1.0f)));
+            spheres_.push_back(sphere);
+        }
+    }
+
+    for (auto& sphere : spheres_) {
+        sphere.SetStuck(false);
+        sphere.SetSticky(false);
+    }
+}
+
+glm::vec2 Simulation::RestingSpherePos() const
+{
+    return glm::vec2(player_.Pos().x + (kPlayerSize.x - 2 * sphere_radius_) / 2.0f,
+                     (float)h_ - kPlayerSize.y - 2 * sphere_radius_);
+}
+
+void Simulation::OnActivatePowerUp(PowerUp::Type type)
+{
+    events_.push_back({ET_POWER_UP, (int)type, player_.Pos()});
+
+    switch (type) {
+    case PowerUp::T_SPEED:
+        for (auto& sphere : spheres_) {
+            sphere.SetVelocity(sphere.Velocity() * 1.2f);
+        }
+        break;
+    case PowerUp::T_STICKY:
+        for (auto& sphere : spheres_) {
+            sphere.SetSticky(true);
+        }
+        is_sticky_player_ = true;
+        break;
+    case PowerUp::T_PASS_THROUGH:
+        for (auto& sphere : spheres_) {
+            sphere.SetPassThrough(true);
+        }
+        break;
+    case PowerUp::T_PAD_SIZE_INCREASE:
+        player_.SetSize(glm::vec2(player_.Size().x + 50, player_.Size().y));
+        break;
+    case PowerUp::T_CONFUSE:
+        is_confuse_ = true;
+        break;
+    case PowerUp::T_CHAOS:
+        is_chaos_ = true;
+        break;
+    case PowerUp::T_MULTI_BALL:
+        for (int index = 0, count = (int)spheres_.size(); index < count; ++index) {
+            SplitSphere(index, kSplitAngles);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void Simulation::OnDeactivatePowerUp(PowerUp::Type type)
+{
+    switch (type) {
+    case PowerUp::T_STICKY:
+        for (auto& sphere : spheres_) {
+            sphere.SetSticky(false);
+        }
+        is_sticky_player_ = false;
+        break;
+    case PowerUp::T_PASS_THROUGH:
+        for (auto& sphere : spheres_) {
+            sphere.SetPassThrough(false);
+        }
+        break;
+    case PowerUp::T_CONFUSE:
+        is_confuse_ = false;
+        break;
+    case PowerUp::T_CHAOS:
+        is_chaos_ = false;
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,210 @@
+#ifndef SIMULATION_H_
+#define SIMULATION_H_
+
+#include <vector>
+
+#include "game_level.h"
+#include "game_object.h"
+#include "game_state.h"
+#include "power_up_manager.h"
+#include "rng.h"
+
+/**
+ * @brief The game rules without Qt or GL: balls, paddle, bricks, power-ups, lives and state,
+ * advanced in fixed steps by Step(). The same seed and inputs replay the same game, in
+ * GameScene at the display rate or in a tool as fast as the CPU allows.
+ *
+ * What a renderer needs besides the state, sounds, shakes and destroyed bricks, is reported as
+ * the events of the last step.
+ */
+class Simulation
+{
+public:
+    // 125 Hz keeps the step a whole number of milliseconds for the power-up timers. The ball
+    // uses swept collision, so the rate does not limit its speed.
+    static constexpr float kStep = 1.0f / 125.0f;
+
+    /**
+     * @brief Input gathered since the last step, applied at the start of the next one.
+     */
+    struct Inputs
+    {
+        float player_dx = 0.0f; // paddle move in pixels
+        int level_step = 0;     // levels to go forward, negative to go back, in the menu only
+        bool is_enter = false;  // start a game or leave the win screen
+        bool is_launch = false; // release the ball from the paddle
+    };
+
+    enum EventType
+    {
+        ET_BRICK_DESTROYED, // index of the brick, pos
+        ET_SOLID_HIT,
+        ET_PLAYER_HIT,
+        ET_POWER_UP // index is the activated PowerUp::Type
+    };
+
+    struct Event
+    {
+        EventType type;
+        int index;
+        glm::vec2 pos;
+    };
+
+    explicit Simulation(unsigned int seed = 1);
+    ~Simulation();
+
+    void Seed(unsigned int seed);
+    void Resize(int w, int h);
+
+    /**
+     * @brief Stress mode, a launch releases count balls fanned out over the paddle instead of one.
+     * The balls shrink as the count grows, so together they cover about the same share of the
+     * field and the ball-ball pairs per ball stay few.
+     */
+    void SetLaunchCount(int count);
+
+    /**
+     * @brief Apply the inputs and advance by kStep. Events() holds what happened in the step.
+     */
+    void Step(const Inputs& inputs);
+
+    /**
+     * @brief Autoplay, the paddle move of up to max_dx that keeps the paddle under the lowest ball
+     * coming down.
+     * @param aim Where the ball meets the paddle, -0.5 is the left end and 0.5 the right one. Off
+     * center by default, so the ball does not bounce straight up forever.
+     */
+    float FollowBall(float max_dx, float aim = -0.125f) const;
+
+    /**
+     * @brief The next steps change the state even without input.
+     */
+    bool IsMoving() const;
+
+    inline const std::vector<Event>& Events() const;
+    inline long long Ticks() const;
+
+    inline const GameState& State() const;
+    inline const GameLevel& Level() const;
+    inline const GameObject& Player() const;
+    // At least one ball, the first one rests on the paddle after a reset.
+    inline const std::vector<SphereObject>& Spheres() const;
+    inline const PowerUpManager& PowerUps() const;
+
+    // effects of the power-ups and the win screen, shown by the renderer
+    inline bool IsStickyPlayer() const;
+    inline bool IsConfuse() const;
+    inline bool IsChaos() const;
+
+private:
+    enum SphereContact
+    {
+        SC_NONE,
+        SC_BORDER,
+        SC_PLAYER,
+        SC_BRICK
+    };
+
+    void ApplyInputs(const Inputs& inputs);
+    void MovePlayer(float dx);
+    void PlaceObjects();
+
+    void MoveSphere(SphereObject* sphere, float dt);
+    void BounceOffPlayer(SphereObject* sphere);
+    void DoCollision();
+    void CollideSpheres();
+    void CheckSpherePos();
+    void ResetState(GameState::StateFlag state);
+
+    /**
+     * @brief Add moving copies of the ball with the velocity turned by the given angles, up to the
+     * limit of balls.
+     */
+    void SplitSphere(int index, const std::vector<float>& angles);
+    void LaunchSpheres();
+    glm::vec2 RestingSpherePos() const;
+
+    // callbacks
+    void OnActivatePowerUp(PowerUp::Type type);
+    void OnDeactivatePowerUp(PowerUp::Type type);
+
+private:
+    int w_;
+    int h_;
+    long long ticks_;
+    int launch_count_;
+    float sphere_radius_;
+
+    Rng rng_;
+    GameState game_state_;
+    GameLevel game_level_;
+    GameObject player_;
+    std::vector<SphereObject> spheres_;
+    PowerUpManager powerup_manager_;
+
+    bool is_sticky_player_;
+    bool is_confuse_;
+    bool is_chaos_;
+
+    std::vector<Event> events_;
+
+    // uniform grid of the balls for the ball-ball pairs, rebuilt every step
+    int sphere_grid_cols_;
+    int sphere_grid_rows_;
+    float sphere_cell_size_;
+    std::vector<int> sphere_cells_;
+    std::vector<int> sphere_cell_first_;
+    std::vector<int> sphere_cell_items_;
+};
+
+inline const std::vector<Simulation::Event>& Simulation::Events() const
+{
+    return events_;
+}
+
+inline long long Simulation::Ticks() const
+{
+    return ticks_;
+}
+
+inline const GameState& Simulation::State() const
+{
+    return game_state_;
+}
+
+inline const GameLevel& Simulation::Level() const
+{
+    return game_level_;
+}
+
+inline const GameObject& Simulation::Player() const
+{
+    return player_;
+}
+
+inline const std::vector<SphereObject>& Simulation::Spheres() const
+{
+    return spheres_;
+}
+
+inline const PowerUpManager& Simulation::PowerUps() const
+{
+    return powerup_manager_;
+}
+
+inline bool Simulation::IsStickyPlayer() const
+{
+    return is_sticky_player_;
+}
+
+inline bool Simulation::IsConfuse() const
+{
+    return is_confuse_;
+}
+
+inline bool Simulation::IsChaos() const
+{
+    return is_chaos_;
+}
+
+#endif
@@ -0,0 +1,281 @@
+#include "headless_runner.h"
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QImage>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include "audio_manager.h"
+#include "gl_state_cache.h"
+
+// paddle speed of the scripted player, in pixels per second
+constexpr float kAutoplaySpeed = 600.0f;
+
+bool HeadlessRunner::IsRequested(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--headless") == 0)
+            return true;
+    }
+
+    return false;
+}
+
+bool HeadlessRunner::ParseOptions(const QStringList& arguments, Options* options)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("BreakOut headless frame benchmark");
+    parser.addHelpOption();
+
+    QCommandLineOption headless_option("headless", "Render offscreen and exit.");
+    QCommandLineOption frames_option("frames", "Number of frames to render.", "n", "600");
+    QCommandLineOption size_option("size", "Frame size.", "WxH", "1366x768");
+    QCommandLineOption fps_option("fps", "Simulated frame rate.", "n", "60");
+    QCommandLineOption seed_option("seed", "Random seed of the scripted game.", "n", "1");
+    QCommandLineOption balls_option("balls", "Balls released per launch, the stress mode.", "n",
+                                    "1");
+    QCommandLineOption gpu_particles_option("gpu-particles",
+                                            "Simulate the particles with transform feedback.");
+    QCommandLineOption timings_option("timings", "Write per-frame timings as csv.", "file");
+    QCommandLineOption dump_option("dump", "Save frames as png into a directory.", "dir");
+    QCommandLineOption dump_every_option("dump-every",
+                                         "Dump every n-th frame, by default only the last one.",
+                                         "n", "0");
+    parser.addOptions({headless_option, frames_option, size_option, fps_option, seed_option,
+                       balls_option, gpu_particles_option, timings_option, dump_option,
+                       dump_every_option});
+
+    // Prints the help or the error and exits on bad options.
+    parser.process(arguments);
+
+    bool ok_frames = false;
+    bool ok_fps = false;
+    bool ok_seed = false;
+    bool ok_balls = false;
+    bool ok_dump_every = false;
+    options->frames = parser.value(frames_option).toInt(&ok_frames);
+    options->fps = parser.value(fps_option).toInt(&ok_fps);
+    options->seed = parser.value(seed_option).toUInt(&ok_seed);
+    options->balls = parser.value(balls_option).toInt(&ok_balls);
+    options->dump_every = parser.value(dump_every_option).toInt(&ok_dump_every);
+    if (!ok_frames || !ok_fps || !ok_seed || !ok_balls || !ok_dump_every ||
+        options->frames <= 0 || options->fps <= 0 || options->balls <= 0 ||
+        options->dump_every < 0) {
+        std::cout << "Invalid headless options." << std::endl;
+        return false;
+    }
+
+    QStringList size = parser.value(size_option).split('x');
+    bool ok_width = false;
+    bool ok_height = false;
+    if (size.size() == 2) {
+        options->width = size[0].toInt(&ok_width);
+        options->height = size[1].toInt(&ok_height);
+    }
+    if (!ok_width || !ok_height || options->width <= 0 || options->height <= 0) {
+        std::cout << "Invalid frame size: " << parser.value(size_option).toStdString()
+                  << std::endl;
+        return false;
+    }
+
+    options->is_gpu_particles = parser.isSet(gpu_particles_option);
+    options->timings_file = parser.value(timings_option);
+    options->dump_dir = parser.value(dump_option);
+
+    return true;
+}
+
+HeadlessRunner::HeadlessRunner(const Options& options)
+    : options_(options)
+{}
+
+HeadlessRunner::~HeadlessRunner()
+{
+    if (!context_.makeCurrent(&surface_))
+        return;
+
+    // The scene and the fbo own GL objects, release them with the context current.
+    scene_.reset();
+    fbo_.reset();
+
+    context_.doneCurrent();
+}
+
+int HeadlessRunner::Run()
+{
+    if (!InitContext())
+        return 1;
+
+    Singleton<AudioManager>::Instance()->SetMuted(true);
+
+    scene_ = std::make_unique<GameScene>();
+    scene_->Initialize();
+    scene_->Resize(options_.width, options_.height);
+    // Every run starts from the same fully loaded scene.
+    scene_->WaitLoaded();
+    scene_->SetGpuParticles(options_.is_gpu_particles);
+    scene_->Profiler()->SetEnabled(true);
+
+    // The scene seeds the simulation and rand() with the time while initializing, the script must
+    // not depend on it. rand() is left to the particles.
+    scene_->Seed(options_.seed);
+    srand(options_.seed);
+    scene_->SetLaunchCount(options_.balls);
+
+    if (!options_.dump_dir.isEmpty()) {
+        QDir().mkpath(options_.dump_dir);
+    }
+
+    double frame_time = 1.0 / options_.fps;
+    timings_.reserve(options_.frames);
+
+    QElapsedTimer cpu_timer;
+    for (int frame = 0; frame < options_.frames; ++frame) {
+        Singleton<GlStateCache>::Instance()->BeginFrame();
+
+        fbo_->bind();
+        glViewport(0, 0, options_.width, options_.height);
+
+        FrameTiming timing;
+
+        cpu_timer.start();
+        PlayScript();
+        scene_->Advance(frame_time);
+        timing.sim_ms = cpu_timer.nsecsElapsed() / 1e6;
+
+        cpu_timer.restart();
+        scene_->Render(fbo_->handle());
+        timing.submit_ms = cpu_timer.nsecsElapsed() / 1e6;
+
+        // Waiting for the results keeps the CPU and the GPU in lock step, which is fine here.
+        scene_->Profiler()->Drain();
+        timing.stage_ms = scene_->Profiler()->LastFrameMs();
+        timing.gpu_ms = 0.0;
+        for (float ms : timing.stage_ms) {
+            timing.gpu_ms += ms;
+        }
+
+        timings_.emplace_back(timing);
+
+        bool is_last = frame == options_.frames - 1;
+        bool is_dump_frame = options_.dump_every > 0 && frame % options_.dump_every == 0;
+        if (!options_.dump_dir.isEmpty() && (is_last || is_dump_frame)) {
+            DumpFrame(frame);
+        }
+    }
+
+    WriteTimings();
+    PrintSummary();
+
+    return 0;
+}
+
+bool HeadlessRunner::InitContext()
+{
+    context_.setFormat(QSurfaceFormat::defaultFormat());
+    if (!context_.create()) {
+        std::cout << "Create OpenGL context fail." << std::endl;
+        return false;
+    }
+
+    surface_.setFormat(context_.format());
+    surface_.create();
+    if (!context_.makeCurrent(&surface_)) {
+        std::cout << "Make offscreen surface current fail." << std::endl;
+        return false;
+    }
+
+    initializeOpenGLFunctions();
+
+    fbo_ = std::make_unique<QOpenGLFramebufferObject>(options_.width, options_.height);
+
+    return true;
+}
+
+void HeadlessRunner::PlayScript()
+{
+    // Keep a game running: start one from the menu or the win screen, relaunch a ball resting on
+    // the paddle and let the paddle follow the ball.
+    if (scene_->State() != GameState::SF_ACTIVE) {
+        scene_->HandleEnterInput();
+    }
+    scene_->HandleSpaceInput();
+    scene_->FollowBall(kAutoplaySpeed / options_.fps);
+}
+
+void HeadlessRunner::DumpFrame(int frame)
+{
+    QString file =
+        QDir(options_.dump_dir).filePath(QString("frame_%1.png").arg(frame, 5, 10, QChar('0')));
+    if (!fbo_->toImage().save(file)) {
+        std::cout << "Save frame fail. path: " << file.toStdString() << std::endl;
+    }
+}
+
+void HeadlessRunner::WriteTimings()
+{
+    if (options_.timings_file.isEmpty())
+        return;
+
+    std::ofstream ofs(options_.timings_file.toStdString(), std::ios_base::out);
+    if (!ofs) {
+        std::cout << "Open timings file fail. path: " << options_.timings_file.toStdString()
+                  << std::endl;
+        return;
+    }
+
+    ofs << "frame,sim_ms,submit_ms,gpu_ms";
+    for (auto& stage : scene_->Profiler()->CalcStats()) {
+        ofs << ",gpu_" << stage.name << "_ms";
+    }
+    ofs << '\n';
+
+    ofs << std::fixed << std::setprecision(4);
+    for (size_t i = 0; i < timings_.size(); ++i) {
+        ofs << i << ',' << timings_[i].sim_ms << ',' << timings_[i].submit_ms << ','
+            << timings_[i].gpu_ms;
+        for (float ms : timings_[i].stage_ms) {
+            ofs << ',' << ms;
+        }
+        ofs << '\n';
+    }
+}
+
+void HeadlessRunner::PrintSummary()
+{
+    if (timings_.empty())
+        return;
+
+    FrameTiming sum = {0.0, 0.0, 0.0, {}};
+    FrameTiming max = {0.0, 0.0, 0.0, {}};
+    for (auto& timing : timings_) {
+        sum.sim_ms += timing.sim_ms;
+        sum.submit_ms += timing.submit_ms;
+        sum.gpu_ms += timing.gpu_ms;
+        max.sim_ms = std::max(max.sim_ms, timing.sim_ms);
+        max.submit_ms = std::max(max.submit_ms, timing.submit_ms);
+        max.gpu_ms = std::max(max.gpu_ms, timing.gpu_ms);
+    }
+
+    double count = (double)timings_.size();
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << timings_.size() << " frames at " << options_.width << "x" << options_.height
+              << ", " << options_.balls << " balls per launch, renderer "
+              << (const char*)glGetString(GL_RENDERER) << std::endl;
+    std::cout << "sim     avg " << sum.sim_ms / count << " ms  max " << max.sim_ms << " ms"
+              << std::endl;
+    std::cout << "submit  avg " << sum.submit_ms / count << " ms  max " << max.submit_ms << " ms"
+              << std::endl;
+    std::cout << "gpu     avg " << sum.gpu_ms / count << " ms  max " << max.gpu_ms << " ms"
+              << std::endl;
+
+    for (auto& stage : scene_->Profiler()->CalcStats()) {
+        std::cout << "  " << std::left << std::setw(10) << stage.name << std::right << "avg "
+                  << stage.avg_ms << " ms  p95 " << stage.p95_ms << " ms" << std::endl;
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef HEADLESS_RUNNER_H_
+#define HEADLESS_RUNNER_H_
+
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions_3_3_Core>
+#include <QStringList>
+#include <memory>
+#include <vector>
+
+#include "game_scene.h"
+
+/**
+ * @brief Renders the game without a window, into an fbo on an offscreen surface. A scripted
+ * game is played for a fixed number of frames at a fixed frame time, so runs with the same seed
+ * produce the same images.
+ *
+ * Per-frame timings, with the GPU time of every render stage, are written as csv. Frames can be
+ * dumped as png for golden-image checks.
+ */
+class HeadlessRunner : protected QOpenGLFunctions_3_3_Core
+{
+public:
+    struct Options
+    {
+        int frames = 600;
+        int width = 1366;
+        int height = 768;
+        int fps = 60;              // simulated frame rate, not a real-time limit
+        unsigned int seed = 1;
+        int balls = 1;             // balls per launch, above 1 the stress mode
+        bool is_gpu_particles = false;
+        QString timings_file;      // csv, empty to skip
+        QString dump_dir;          // png dumps, empty to skip
+        int dump_every = 0;        // 0 dumps the last frame only
+    };
+
+    /**
+     * @brief Checked before the application exists, it decides the platform plugin.
+     */
+    static bool IsRequested(int argc, char* argv[]);
+
+    /**
+     * @return False if the arguments are invalid, the error is printed.
+     */
+    static bool ParseOptions(const QStringList& arguments, Options* options);
+
+    HeadlessRunner(const Options& options);
+    ~HeadlessRunner();
+
+    /**
+     * @return The process exit code.
+     */
+    int Run();
+
+private:
+    struct FrameTiming
+    {
+        double sim_ms;    // fixed-step simulation on the CPU
+        double submit_ms; // CPU time spent issuing the frame
+        double gpu_ms;    // sum of the GPU stages
+        std::vector<float> stage_ms;
+    };
+
+    bool InitContext();
+    void PlayScript();
+    void DumpFrame(int frame);
+    void WriteTimings();
+    void PrintSummary();
+
+private:
+    Options options_;
+
+    QOffscreenSurface surface_;
+    QOpenGLContext context_;
+    std::unique_ptr<QOpenGLFramebufferObject> fbo_;
+
+    std::unique_ptr<GameScene> scene_;
+    std::vector<FrameTiming> timings_;
+};
+
+#endif
@@ -3,18 +3,36 @@
 #include <QApplication>
 #include <QSurfaceFormat>
 
+#include "headless_runner.h"
+
 int main(int argc, char* argv[])
 {
     QSurfaceFormat surface_format;
     surface_format.setVersion(3, 3);
     surface_format.setProfile(QSurfaceFormat::CoreProfile);
+    surface_format.setSwapInterval(1);
     QSurfaceFormat::setDefaultFormat(surface_format);
 
     // ͬڵQOpenGLWidgetʵ֮Ĺ
     qApp->setAttribute(Qt::AA_ShareOpenGLContexts);
 
+    // The headless benchmark runs without a display unless a platform is chosen explicitly.
+    bool is_headless = HeadlessRunner::IsRequested(argc, argv);
+    if (is_headless && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
     QApplication a(argc, argv);
 
+    if (is_headless) {
+        HeadlessRunner::Options options;
+        if (!HeadlessRunner::ParseOptions(a.arguments(), &options))
+            return 1;
+
+        HeadlessRunner runner(options);
+        return runner.Run();
+    }
+
     MainWindow w;
     w.show();
     return a.exec();
@@ -0,0 +1,87 @@
+/**
+ * @brief Offline texture cooking, run by the build. Packs the png sprites into atlas pages and
+ * writes every page and every other image as a .ctex blob that ResourceManager maps at startup.
+ *
+ * Usage: asset_cooker <image dir> <output dir>
+ */
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QImage>
+#include <iostream>
+
+#include "cooked_texture.h"
+#include "texture_atlas.h"
+
+// Full mip chain for stand-alone textures, as ResourceManager builds them.
+constexpr int kMaxMipLevel = 16;
+
+static bool WriteBlob(const QDir& out_dir, const QString& name, const QByteArray& blob)
+{
+    QFile file(out_dir.filePath(name + ".ctex"));
+    if (!file.open(QIODevice::WriteOnly) || file.write(blob) != blob.size()) {
+        std::cout << "Write cooked texture fail. path: " << file.fileName().toStdString()
+                  << std::endl;
+        return false;
+    }
+
+    std::cout << "  " << name.toStdString() << ".ctex " << blob.size() / 1024 << " KB"
+              << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    // image format plugins (jpeg) are loaded through the application
+    QCoreApplication app(argc, argv);
+
+    QStringList args = app.arguments();
+    if (args.size() != 3) {
+        std::cout << "Usage: asset_cooker <image dir> <output dir>" << std::endl;
+        return 1;
+    }
+
+    QDir image_dir(args[1]);
+    QDir out_dir(args[2]);
+    if (!out_dir.mkpath(".")) {
+        std::cout << "Create output dir fail. path: " << args[2].toStdString() << std::endl;
+        return 1;
+    }
+
+    // sprites, packed exactly as they are at runtime
+    TextureAtlas atlas;
+    for (auto& file : image_dir.entryList(QStringList() << "*.png", QDir::Files, QDir::Name)) {
+        atlas.Add(QFileInfo(file).baseName().toStdString(), QImage(image_dir.filePath(file)));
+    }
+
+    // ResourceManager reads pages until one is missing, pages left from a larger cook would be
+    // loaded with outdated sprites.
+    for (auto& file : out_dir.entryList(QStringList() << "atlas_*.ctex", QDir::Files)) {
+        if (!out_dir.remove(file)) {
+            std::cout << "Remove old atlas page fail. path: " << file.toStdString() << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<QByteArray> pages = atlas.Cook();
+    for (size_t page = 0; page < pages.size(); ++page) {
+        if (!WriteBlob(out_dir, QString("atlas_%1").arg((int)page), pages[page]))
+            return 1;
+    }
+
+    // stand-alone textures
+    for (auto& file : image_dir.entryList(QStringList() << "*.jpg", QDir::Files, QDir::Name)) {
+        QImage image(image_dir.filePath(file));
+        if (image.isNull()) {
+            std::cout << "Decode image fail. path: " << file.toStdString() << std::endl;
+            return 1;
+        }
+
+        QByteArray blob =
+            CookedTexture::Cook(image.convertToFormat(QImage::Format_RGB32), kMaxMipLevel);
+        if (!WriteBlob(out_dir, QFileInfo(file).baseName(), blob))
+            return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,141 @@
+/**
+ * @brief Microbenchmark of the brick collision tests. The same circles are tested against the
+ * same bricks three ways: the array of GameObject the level used to keep, BrickStore one brick at
+ * a time, and BrickStore in batches of 4 or 8. The hit counts must agree.
+ *
+ * Usage: brick_bench [brick count] [query count]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "brick_store.h"
+#include "game_object.h"
+
+struct Query
+{
+    glm::vec2 center;
+    float radius;
+};
+
+// The per-brick test of the GameObject path, through the accessors.
+// The level kept the destroyed flag in the object, here it is the alive list next to it.
+static void OverlapObjects(const std::vector<GameObject>& bricks, const std::vector<bool>& alive,
+                           const Query& query, std::vector<int>& hits)
+{
+    for (int i = 0; i < (int)bricks.size(); ++i) {
+        if (!alive[i])
+            continue;
+
+        auto& brick = bricks[i];
+        glm::vec2 pos = brick.Pos();
+        glm::vec2 size = brick.Size();
+        float dx = std::max(std::max(pos.x - query.center.x, query.center.x - pos.x - size.x),
+                            0.0f);
+        float dy = std::max(std::max(pos.y - query.center.y, query.center.y - pos.y - size.y),
+                            0.0f);
+        if (dx * dx + dy * dy <= query.radius * query.radius) {
+            hits.push_back(i);
+        }
+    }
+}
+
+template <typename Test>
+static double Run(const char* name, int bricks, const std::vector<Query>& queries, Test test,
+                  std::vector<int>& hits)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (auto& query : queries) {
+        test(query, hits);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    double ns = elapsed.count() / ((double)bricks * queries.size());
+
+    std::cout << "  " << std::left << std::setw(12) << name << std::right << std::fixed
+              << std::setprecision(3) << ns << " ns/brick, " << hits.size() << " hits"
+              << std::endl;
+    return ns;
+}
+
+int main(int argc, char* argv[])
+{
+    int brick_count = argc > 1 ? std::atoi(argv[1]) : 4096;
+    int query_count = argc > 2 ? std::atoi(argv[2]) : 4096;
+    if (brick_count <= 0 || query_count <= 0) {
+        std::cout << "Usage: brick_bench [brick count] [query count]" << std::endl;
+        return 1;
+    }
+
+    // a level grid with a fixed seed, some bricks already destroyed
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    int cols = 64;
+    int rows = (brick_count + cols - 1) / cols;
+    glm::vec2 size(20.0f, 10.0f);
+
+    std::vector<GameObject> objects;
+    std::vector<bool> alive(brick_count, true);
+    BrickStore store;
+    store.Reserve(brick_count);
+    for (int i = 0; i < brick_count; ++i) {
+        glm::vec2 pos(size.x * (i % cols), size.y * (i / cols));
+        objects.emplace_back(pos, size);
+        store.Add(pos.x, pos.y, size.x, size.y, 2);
+
+        if (unit(random) < 0.25f) {
+            alive[i] = false;
+            store.Kill(i);
+        }
+    }
+
+    std::vector<Query> queries;
+    for (int i = 0; i < query_count; ++i) {
+        float x = unit(random) * size.x * cols;
+        float y = unit(random) * size.y * rows;
+        queries.push_back({glm::vec2(x, y), 2.0f + unit(random) * 30.0f});
+    }
+
+    std::cout << brick_count << " bricks, " << query_count << " circles, batch test "
+              << BrickStore::SimdName() << std::endl;
+
+    std::vector<int> object_hits;
+    double object_ns = Run(
+        "GameObject", brick_count, queries,
+        [&](const Query& query, std::vector<int>& hits) {
+            OverlapObjects(objects, alive, query, hits);
+        },
+        object_hits);
+
+    std::vector<int> scalar_hits;
+    Run(
+        "scalar", brick_count, queries,
+        [&](const Query& query, std::vector<int>& hits) {
+            store.OverlapCircleScalar(0, store.Size(), query.center.x, query.center.y,
+                                      query.radius, hits);
+        },
+        scalar_hits);
+
+    std::vector<int> batch_hits;
+    double batch_ns = Run(
+        BrickStore::SimdName(), brick_count, queries,
+        [&](const Query& query, std::vector<int>& hits) {
+            store.OverlapCircle(0, store.Size(), query.center.x, query.center.y, query.radius,
+                                hits);
+        },
+        batch_hits);
+
+    if (object_hits != scalar_hits || object_hits != batch_hits) {
+        std::cout << "Hit mismatch between the collision paths." << std::endl;
+        return 1;
+    }
+
+    std::cout << "  speedup " << std::setprecision(2) << object_ns / batch_ns << "x" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+/**
+ * @brief Runs the simulation without a window, GL or Qt, as fast as the CPU allows. The paddle
+ * follows the ball and aims somewhere else after every hit, a game is started again whenever it
+ * ends. The checksum of the final state is the same for the same arguments on every run and
+ * build.
+ *
+ * Run from the repository root, the levels are read from res/levels.
+ *
+ * With a ball count above 1 every launch releases that many balls, the stress mode of the game.
+ * The time per ball and step should stay flat as the count grows.
+ *
+ * Usage: sim_bench [step count] [seed] [ball count]
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#include "rng.h"
+#include "simulation.h"
+
+// pixels per second, a bit faster than the keyboard so the autoplay rarely misses
+constexpr float kAutoplaySpeed = 600.0f;
+
+static unsigned int Checksum(const Simulation& simulation)
+{
+    unsigned int hash = 2166136261u;
+    auto mix = [&hash](unsigned int value) {
+        hash ^= value;
+        hash *= 16777619u;
+    };
+
+    mix((unsigned int)simulation.Ticks());
+    mix((unsigned int)simulation.State().State());
+    mix((unsigned int)simulation.State().Lives());
+    mix((unsigned int)simulation.Level().Level());
+    mix((unsigned int)simulation.Level().Revision());
+    mix((unsigned int)simulation.Spheres().size());
+    for (auto& sphere : simulation.Spheres()) {
+        mix((unsigned int)sphere.Pos().x);
+        mix((unsigned int)sphere.Pos().y);
+    }
+    mix((unsigned int)simulation.Player().Pos().x);
+    return hash;
+}
+
+int main(int argc, char* argv[])
+{
+    long long step_count = argc > 1 ? std::atoll(argv[1]) : 1000000;
+    unsigned int seed = argc > 2 ? (unsigned int)std::strtoul(argv[2], nullptr, 10) : 1;
+    int ball_count = argc > 3 ? std::atoi(argv[3]) : 1;
+    if (step_count <= 0 || ball_count <= 0) {
+        std::cout << "Usage: sim_bench [step count] [seed] [ball count]" << std::endl;
+        return 1;
+    }
+
+    Simulation simulation(seed);
+    simulation.Resize(1366, 768);
+    simulation.SetLaunchCount(ball_count);
+
+    // the autoplay has its own stream, the simulation's draws stay the same as in the game
+    Rng aim_rng(seed);
+    float aim = -0.125f;
+
+    long long bricks = 0;
+    long long games = 0;
+    long long ball_steps = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < step_count; ++i) {
+        Simulation::Inputs inputs;
+        if (simulation.State().State() != GameState::SF_ACTIVE) {
+            inputs.is_enter = true;
+            games += simulation.State().State() == GameState::SF_MENU;
+        }
+        inputs.is_launch = true;
+        inputs.player_dx = simulation.FollowBall(kAutoplaySpeed * Simulation::kStep, aim);
+
+        simulation.Step(inputs);
+        ball_steps += simulation.Spheres().size();
+
+        for (auto& event : simulation.Events()) {
+            if (event.type == Simulation::ET_BRICK_DESTROYED) {
+                ++bricks;
+            } else if (event.type == Simulation::ET_PLAYER_HIT) {
+                aim = (aim_rng.NextInt(81) - 40) / 100.0f;
+            }
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    double seconds = elapsed.count();
+    std::cout << step_count << " steps in " << std::fixed << std::setprecision(3) << seconds
+              << " s, " << std::setprecision(0) << step_count / seconds << " steps/s, "
+              << std::setprecision(1) << step_count * Simulation::kStep / seconds
+              << "x real time, " << std::setprecision(1) << elapsed.count() * 1e9 / ball_steps
+              << " ns per ball step, " << (double)ball_steps / step_count << " balls on average"
+              << std::endl;
+    std::cout << "  " << games << " games, " << bricks << " bricks destroyed, lives "
+              << simulation.State().Lives() << ", checksum " << std::hex << Checksum(simulation)
+              << std::dec << std::endl;
+
+    return 0;
+}